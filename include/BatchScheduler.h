@@ -0,0 +1,76 @@
+#pragma once
+#include "ModelHandler.h"
+#include "ParallelDSP.h"
+#include "kiss_fft.h"
+#include <cstdint>
+#include <vector>
+
+struct SchedulerConfig {
+    size_t max_batch = 4;     // segments per run, clamped to 1 for models with a fixed batch dimension
+    bool pack_tails = false;  // let the short last segments of several files share one segment along time (approximate, see below)
+    size_t guard_frames = 8;  // silent frames kept between packed tails, far below MDX-Net's receptive field
+    size_t memory_budget = 0; // bytes, checked after every run (0 = unlimited)
+};
+
+struct SchedulerStats {
+    size_t files = 0;
+    size_t runs = 0;            // model Run calls
+    size_t segments = 0;        // segments sent to the model
+    size_t useful_frames = 0;   // frames that belong to a file
+    size_t padded_frames = 0;   // zero frames sent only to fill a segment
+};
+
+// packs the segments of several files into full model batches and routes every
+// segment's output back to its file's overlap-add buffers.
+// segments of a file are always synthesized in order, and each batch entry holds one
+// segment, so with pack_tails off a file's output does not depend on the other files.
+// pack_tails places tails next to each other in time inside one segment; the model sees
+// neighbouring files across the guard frames and each tail at a shifted offset, so the
+// tails only approximate their per-file output.
+class BatchScheduler {
+    private:
+
+    struct FileState {
+        std::vector<float> left_padded;
+        std::vector<float> right_padded;
+        std::vector<float> left_output;
+        std::vector<float> right_output;
+        size_t num_frames;
+    };
+
+    // a run of frames from one file placed at time_offset inside a segment
+    struct SegmentPart {
+        size_t file;
+        size_t first_frame;
+        size_t count;
+        size_t time_offset;
+    };
+
+    ModelHandler& model;
+    ParallelDSP& dsp;
+    SchedulerConfig config;
+    SchedulerStats stats;
+
+    std::vector<FileState> files;
+
+    // every segment to run, each a list of parts; a file's parts appear in frame order
+    std::vector<std::vector<SegmentPart>> plan_segments() const;
+
+    void run_batch(const std::vector<std::vector<SegmentPart>>& segments, size_t first, size_t count);
+
+    public:
+
+    BatchScheduler(ModelHandler& model, ParallelDSP& dsp, const SchedulerConfig& config);
+
+    // takes reflect-padded channels, returns the file's id
+    size_t add_file(std::vector<float> left_padded, std::vector<float> right_padded);
+
+    // runs every segment of every added file
+    void run();
+
+    // moves the overlap-added (padded length, unnormalized) output of a file out of the scheduler
+    void take_output(size_t file, std::vector<float>& left, std::vector<float>& right);
+
+    const SchedulerStats& get_stats() const { return stats; }
+
+};
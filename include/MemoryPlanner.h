@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// sizes of everything the pipeline allocates per file, per segment and per thread
+struct ModelGeometry {
+    size_t n_fft = 4096;
+    size_t hop_length = 1024;
+    size_t segment_frames = 256;
+    size_t segment_values = 4 * 2048 * 256;  // floats in one [4, 2048, 256] segment
+    size_t model_bytes = 0;                  // onnx file size
+    // onnx runtime working memory per segment in a batch. rough default for MDX-Net sized models;
+    // separator measures it on the loaded model when planning under a budget (--activation-memory overrides)
+    size_t activation_bytes_per_segment = 192ull << 20;
+};
+
+struct MemoryPlan {
+    size_t max_batch;           // segments per model run
+    size_t files_per_window;    // files loaded and packed together
+    size_t concurrent_sessions; // separator processes of this shape that fit in the budget
+    size_t estimated_peak;      // bytes, for one process
+    bool fits;                  // false if even one file at batch 1 exceeds the budget
+};
+
+// estimated peak resident bytes of one separator process
+size_t estimate_peak_memory(const ModelGeometry& geometry, size_t num_samples, size_t files_per_window, unsigned int threads, size_t max_batch);
+
+// largest batch and file window (up to the requested ones) whose estimate stays under budget_bytes.
+// num_samples is the longest input in samples per channel; segment length is fixed by the model.
+MemoryPlan plan_memory(const ModelGeometry& geometry, size_t num_samples, size_t files_per_window, unsigned int threads, size_t max_batch, size_t budget_bytes);
+
+// resident and peak resident bytes of this process (VmRSS / VmHWM), 0 if unavailable
+size_t current_memory_usage();
+size_t peak_memory_usage();
+
+// resets the peak (VmHWM) to the current resident size, false where the kernel does not support it
+bool reset_peak_memory_usage();
+
+// throws if the process's peak resident memory so far went over budget_bytes (0 disables the check)
+void enforce_memory_budget(size_t budget_bytes, const std::string& stage);
+
+// parses sizes like "512M", "4G" or "2048" (megabytes)
+size_t parse_memory_size(const std::string& text);
+
+std::string format_megabytes(size_t bytes);
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <onnxruntime_cxx_api.h>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 class ModelHandler {
 
@@ -10,6 +13,12 @@ class ModelHandler {
         std::unique_ptr<Ort::Session> model;
         Ort::SessionOptions config;
         Ort::AllocatorWithDefaultOptions allocator;
+        std::vector<int64_t> input_dims; // -1 marks a dynamic dimension
+        ONNXTensorElementDataType input_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+        ONNXTensorElementDataType output_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+
+        //scratch buffer for fp16 inputs to avoid reallocation
+        std::vector<uint16_t> _half_input;
 
     public:
         ModelHandler(): env(ORT_LOGGING_LEVEL_WARNING, "ModelHandler"){
@@ -20,4 +29,18 @@ class ModelHandler {
 
         std::vector<float> run_inference(const std::vector<float>& input_data, const std::vector<int64_t>& input_shape);
 
+        // input shape declared by the loaded model, empty if no model is loaded
+        const std::vector<int64_t>& get_input_shape() const { return input_dims; }
+
+        // true if the model accepts more than one segment per run
+        bool supports_batching() const { return !input_dims.empty() && input_dims[0] < 0; }
+
+        // "fp32" or "fp16", from the model's input and output element types.
+        // int8 models quantized internally keep float32 inputs and outputs
+        std::string io_precision() const;
+
+        // path of a precision variant prepared offline next to the model:
+        // fp32 -> model.onnx, fp16 -> model.fp16.onnx, int8 -> model.int8.onnx
+        static std::string variant_path(const std::string& model_path, const std::string& precision);
+
 };
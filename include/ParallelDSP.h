@@ -0,0 +1,49 @@
+#pragma once
+#include "DSPCore.h"
+#include "kiss_fft.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// multi-threaded STFT analysis and ISTFT overlap-add synthesis.
+// DSPCore keeps scratch buffers and FFT plans per instance, so each worker thread
+// gets its own DSPCore. results are bit-identical to the serial DSPCore loops.
+class ParallelDSP {
+    private:
+
+    uint32_t n_fft;
+    uint32_t hop_length;
+    unsigned int num_threads;
+
+    // one DSPCore (FFT plans + scratch) per worker thread
+    std::vector<std::unique_ptr<DSPCore>> cores;
+
+    // run fn(worker_index) on num_workers threads (worker 0 runs on the calling thread)
+    void run_workers(unsigned int num_workers, const std::function<void(unsigned int)>& fn);
+
+    // split num_frames frames into contiguous tiles of at least min_frames frames each,
+    // returns num_tiles + 1 frame boundaries
+    std::vector<size_t> plan_tiles(size_t num_frames, size_t min_frames) const;
+
+    public:
+
+    // num_threads == 0 uses std::thread::hardware_concurrency()
+    ParallelDSP(uint32_t n_fft, uint32_t hop_length, unsigned int num_threads = 0);
+
+    unsigned int threads() const { return num_threads; }
+
+    // number of frames the serial analysis loop produces for a padded signal
+    size_t frame_count(size_t padded_length) const;
+
+    // STFT of frames [first_frame, first_frame + count) of an already padded signal
+    std::vector<std::vector<kiss_fft_cpx>> analyze(const std::vector<float>& padded, size_t first_frame, size_t count);
+    std::vector<std::vector<kiss_fft_cpx>> analyze(const std::vector<float>& padded);
+
+    // ISTFT frames and overlap-add them into output, frames[i] starting at (first_frame + i) * hop_length.
+    // the output is split into tiles owned by one thread each; frames straddling a tile boundary are
+    // transformed once by the tile they start in and their spill is added by the next tile's owner,
+    // so no two threads ever write the same sample.
+    void synthesize(const std::vector<std::vector<kiss_fft_cpx>>& frames, size_t first_frame, std::vector<float>& output);
+
+};
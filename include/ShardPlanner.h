@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// one time range of a long input, processed by an independent worker.
+// all positions are in samples per channel of the original input.
+struct Shard {
+    size_t read_start;   // first sample the worker reads, always on the segment grid
+    size_t read_end;     // one past the last sample the worker reads
+    size_t fade_in_start;  // the shard's output ramps in over [fade_in_start, fade_in_end)
+    size_t fade_in_end;
+    size_t fade_out_start; // and ramps out over [fade_out_start, fade_out_end)
+    size_t fade_out_end;
+};
+
+struct ShardConfig {
+    size_t segment_samples = 256 * 1024; // model segment length in samples (segment frames * hop)
+    size_t margin = 4096;                // samples of STFT context kept clear of the crossfade (n_fft)
+    size_t crossfade = 4096;             // crossfade length at each shard boundary
+};
+
+// splits num_samples into at most num_shards ranges. boundaries sit on the segment grid so
+// every worker sees the same frames and segments as a single process would; each shard reads
+// one extra segment (plus margin) on both sides so the crossfade only covers samples that no
+// padded or truncated segment touched.
+std::vector<Shard> plan_shards(size_t num_samples, size_t num_shards, const ShardConfig& config = ShardConfig());
+
+// crossfades the interleaved stereo output of every shard (covering [read_start, read_end))
+// back into one interleaved stereo signal of num_samples samples per channel
+std::vector<float> merge_shards(const std::vector<Shard>& shards, const std::vector<std::vector<float>>& outputs, size_t num_samples);
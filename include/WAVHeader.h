@@ -26,6 +26,19 @@ struct WAVHeader {
 };
 #pragma pack(pop)
 
+// throws unless the header describes audio read_wav can decode: 44.1 kHz mono or stereo,
+// 16-bit PCM or 32-bit float
+void check_wav_header(const WAVHeader& header, const std::string& full_path) {
+
+    if (header.sample_rate != 44100) throw std::runtime_error("unsupported sample rate: " + std::to_string(header.sample_rate) + "expected 44100");
+
+    if (header.audio_format != 1 && header.audio_format != 3 ) throw std::runtime_error("unsupported audio format: " + std::to_string(header.audio_format) + " (expected PCM or flaot)");
+
+    if (header.bits_per_sample != (header.audio_format == 1 ? 16 : 32)) throw std::runtime_error("unsupported bits per sample: " + std::to_string(header.bits_per_sample) + " in " + full_path);
+
+    if (header.num_channels != 1 && header.num_channels != 2) throw std::runtime_error("unsupported channel count: " + std::to_string(header.num_channels) + " in " + full_path);
+}
+
 WAVHeader read_wav(const std::string& full_path, std::vector<float>& stereo_buffer) {
     
     WAVHeader header;
@@ -34,10 +47,9 @@ WAVHeader read_wav(const std::string& full_path, std::vector<float>& stereo_buff
 
     if (!wav_file) throw std::runtime_error("failed to open file: " + full_path);
     wav_file.read(reinterpret_cast<char*> (&header), sizeof(WAVHeader));
+    if (!wav_file) throw std::runtime_error("truncated wav header: " + full_path);
     
-    if (header.sample_rate != 44100) throw std::runtime_error("unsupported sample rate: " + std::to_string(header.sample_rate) + "expected 44100");
-    
-    if (header.audio_format != 1 && header.audio_format != 3 ) throw std::runtime_error("unsupported audio format: " + std::to_string(header.audio_format) + " (expected PCM or flaot)");
+    check_wav_header(header, full_path);
     
     uint32_t num_samples = header.subchunk2_size /  (header.bits_per_sample / 8 );
     
@@ -61,7 +73,7 @@ WAVHeader read_wav(const std::string& full_path, std::vector<float>& stereo_buff
         }
     }
     else {
-        stereo_buffer = buffer;
+        stereo_buffer = std::move(buffer);
     }
     
     header.num_channels = 2;
@@ -75,6 +87,22 @@ WAVHeader read_wav(const std::string& full_path, std::vector<float>& stereo_buff
     return header;
 }
 
+// samples per channel of a wav file, read from the header only
+uint32_t wav_frame_count(const std::string& full_path) {
+
+    WAVHeader header;
+
+    std::ifstream wav_file(full_path, std::ios::binary);
+
+    if (!wav_file) throw std::runtime_error("failed to open file: " + full_path);
+    wav_file.read(reinterpret_cast<char*> (&header), sizeof(WAVHeader));
+    if (!wav_file) throw std::runtime_error("truncated wav header: " + full_path);
+
+    check_wav_header(header, full_path);
+
+    return header.subchunk2_size / (header.bits_per_sample / 8) / header.num_channels;
+}
+
 void write_wav(WAVHeader& header, const std::string& filename, std::vector<float>& buffer) {
     
     std::ofstream output(filename, std::ios::binary);
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// IEEE 754 half precision conversion for fp16 model inputs and outputs.
+// uses F16C instructions when the CPU has them, with a bit-exact scalar fallback.
+
+void float_to_half(const float* input, uint16_t* output, size_t count);
+void half_to_float(const uint16_t* input, float* output, size_t count);
+
+uint16_t float_to_half(float value);
+float half_to_float(uint16_t value);
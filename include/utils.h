@@ -8,3 +8,9 @@ std::vector<float> stft_to_tensor(const std::vector<std::vector<kiss_fft_cpx>>&
 
 // convert the interlearved tensor output back into separate STFT frames
 std::pair<std::vector<std::vector<kiss_fft_cpx>>, std::vector<std::vector<kiss_fft_cpx>>> tensor_to_stft(const std::vector<float>& model_output);
+
+// write frames into one [4, 2048, 256] segment of a (possibly batched) tensor, starting at time column time_offset
+void frames_to_tensor_slot(const std::vector<std::vector<kiss_fft_cpx>>& left_stft, const std::vector<std::vector<kiss_fft_cpx>>& right_stft, float* slot, size_t time_offset);
+
+// read count frames starting at time column time_offset of one [4, 2048, 256] segment, rebuilding the full spectrum
+void tensor_slot_to_frames(const float* slot, size_t time_offset, size_t count, std::vector<std::vector<kiss_fft_cpx>>& left_stft, std::vector<std::vector<kiss_fft_cpx>>& right_stft);
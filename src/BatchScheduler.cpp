@@ -0,0 +1,163 @@
+#include "BatchScheduler.h"
+#include "MemoryPlanner.h"
+#include "utils.h"
+#include <algorithm>
+#include <stdexcept>
+
+// model geometry, [N, 4, 2048, 256]
+static const size_t SEGMENT_FRAMES = 256;
+static const size_t SEGMENT_SIZE = 4 * 2048 * SEGMENT_FRAMES;
+
+BatchScheduler::BatchScheduler(ModelHandler& model, ParallelDSP& dsp, const SchedulerConfig& config)
+:model(model), dsp(dsp), config(config) {
+
+    if (this->config.max_batch == 0) this->config.max_batch = 1;
+}
+
+size_t BatchScheduler::add_file(std::vector<float> left_padded, std::vector<float> right_padded) {
+
+    if (left_padded.size() != right_padded.size()) {
+        throw std::runtime_error("left and right channels differ in length");
+    }
+
+    FileState state;
+    state.num_frames = dsp.frame_count(left_padded.size());
+    state.left_output.assign(left_padded.size(), 0.0f);
+    state.right_output.assign(right_padded.size(), 0.0f);
+    state.left_padded = std::move(left_padded);
+    state.right_padded = std::move(right_padded);
+
+    files.push_back(std::move(state));
+    stats.files++;
+
+    return files.size() - 1;
+}
+
+std::vector<std::vector<BatchScheduler::SegmentPart>> BatchScheduler::plan_segments() const {
+
+    std::vector<std::vector<SegmentPart>> segments;
+    std::vector<SegmentPart> tails;
+
+    for (size_t f = 0; f < files.size(); f++) {
+        size_t full = files[f].num_frames / SEGMENT_FRAMES;
+        for (size_t s = 0; s < full; s++) {
+            segments.push_back({{f, s * SEGMENT_FRAMES, SEGMENT_FRAMES, 0}});
+        }
+
+        size_t remainder = files[f].num_frames % SEGMENT_FRAMES;
+        if (remainder > 0) {
+            tails.push_back({f, full * SEGMENT_FRAMES, remainder, 0});
+        }
+    }
+
+    // tails go after every full segment, so each file's frames are still synthesized in order
+    if (!config.pack_tails) {
+        for (const SegmentPart& tail : tails) {
+            segments.push_back({tail});
+        }
+        return segments;
+    }
+
+    // first-fit decreasing, keeping guard_frames of silence between neighbouring tails
+    std::stable_sort(tails.begin(), tails.end(), [](const SegmentPart& a, const SegmentPart& b) {
+        return a.count > b.count;
+    });
+
+    std::vector<std::vector<SegmentPart>> bins;
+    std::vector<size_t> used;
+
+    for (SegmentPart tail : tails) {
+        bool placed = false;
+
+        for (size_t b = 0; b < bins.size(); b++) {
+            if (used[b] + config.guard_frames + tail.count <= SEGMENT_FRAMES) {
+                tail.time_offset = used[b] + config.guard_frames;
+                used[b] = tail.time_offset + tail.count;
+                bins[b].push_back(tail);
+                placed = true;
+                break;
+            }
+        }
+
+        if (!placed) {
+            tail.time_offset = 0;
+            bins.push_back({tail});
+            used.push_back(tail.count);
+        }
+    }
+
+    segments.insert(segments.end(), bins.begin(), bins.end());
+    return segments;
+}
+
+void BatchScheduler::run_batch(const std::vector<std::vector<SegmentPart>>& segments, size_t first, size_t count) {
+
+    // zero-initialized so gaps between and after parts are silent
+    std::vector<float> tensor(count * SEGMENT_SIZE, 0.0f);
+
+    for (size_t s = 0; s < count; s++) {
+        size_t used_frames = 0;
+
+        for (const SegmentPart& part : segments[first + s]) {
+            FileState& file = files[part.file];
+
+            std::vector<std::vector<kiss_fft_cpx>> left = dsp.analyze(file.left_padded, part.first_frame, part.count);
+            std::vector<std::vector<kiss_fft_cpx>> right = dsp.analyze(file.right_padded, part.first_frame, part.count);
+
+            frames_to_tensor_slot(left, right, tensor.data() + s * SEGMENT_SIZE, part.time_offset);
+            used_frames += part.count;
+        }
+
+        stats.useful_frames += used_frames;
+        stats.padded_frames += SEGMENT_FRAMES - used_frames;
+    }
+
+    std::vector<int64_t> input_shape = {(int64_t)count, 4, 2048, (int64_t)SEGMENT_FRAMES};
+
+    std::vector<float> processed = model.run_inference(tensor, input_shape);
+
+    if (processed.size() != tensor.size()) {
+        throw std::runtime_error("unexpected model output size: " + std::to_string(processed.size()));
+    }
+
+    stats.runs++;
+    stats.segments += count;
+
+    for (size_t s = 0; s < count; s++) {
+        for (const SegmentPart& part : segments[first + s]) {
+            FileState& file = files[part.file];
+
+            std::vector<std::vector<kiss_fft_cpx>> left, right;
+            tensor_slot_to_frames(processed.data() + s * SEGMENT_SIZE, part.time_offset, part.count, left, right);
+
+            dsp.synthesize(left, part.first_frame, file.left_output);
+            dsp.synthesize(right, part.first_frame, file.right_output);
+        }
+    }
+}
+
+void BatchScheduler::run() {
+
+    std::vector<std::vector<SegmentPart>> segments = plan_segments();
+
+    size_t batch_size = model.supports_batching() ? config.max_batch : 1;
+
+    for (size_t i = 0; i < segments.size(); i += batch_size) {
+        run_batch(segments, i, std::min(batch_size, segments.size() - i));
+        enforce_memory_budget(config.memory_budget, "in model run " + std::to_string(stats.runs));
+    }
+}
+
+void BatchScheduler::take_output(size_t file, std::vector<float>& left, std::vector<float>& right) {
+
+    if (file >= files.size()) {
+        throw std::runtime_error("unknown file id: " + std::to_string(file));
+    }
+
+    left = std::move(files[file].left_output);
+    right = std::move(files[file].right_output);
+
+    // the inputs are no longer needed once the output has been taken
+    std::vector<float>().swap(files[file].left_padded);
+    std::vector<float>().swap(files[file].right_padded);
+}
@@ -0,0 +1,135 @@
+#include "MemoryPlanner.h"
+#include "kiss_fft.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+// onnx runtime's own allocations besides weights and activations
+static const size_t RUNTIME_BASE_BYTES = 64ull << 20;
+
+size_t estimate_peak_memory(const ModelGeometry& geometry, size_t num_samples, size_t files_per_window, unsigned int threads, size_t max_batch) {
+
+    size_t samples = num_samples;
+    size_t padded = num_samples + geometry.n_fft;
+
+    // padded left/right inputs and overlap-add outputs held by the scheduler for every file in the window
+    size_t per_file = 4 * padded * sizeof(float);
+
+    // loading one file: the interleaved buffer is freed after the split, so at most
+    // interleaved + split channels, or split channels + padded copies are alive at once
+    size_t loading = std::max(4 * samples * sizeof(float), 2 * samples * sizeof(float) + 2 * padded * sizeof(float));
+
+    // per segment: input tensor, onnx output and its returned copy, plus activations
+    size_t per_segment = 3 * geometry.segment_values * sizeof(float) + geometry.activation_bytes_per_segment;
+
+    // left/right frames of one segment while it is being analyzed or synthesized
+    size_t segment_frames = 2 * geometry.segment_frames * geometry.n_fft * sizeof(kiss_fft_cpx);
+
+    // DSPCore scratch, window and FFT plans per thread, plus the synthesis boundary cache
+    size_t boundary_frames = (geometry.n_fft + geometry.hop_length - 1) / geometry.hop_length;
+    size_t per_thread = 6 * geometry.n_fft * sizeof(kiss_fft_cpx) + (2 + boundary_frames) * geometry.n_fft * sizeof(float);
+
+    return 2 * geometry.model_bytes + RUNTIME_BASE_BYTES
+         + threads * per_thread
+         + files_per_window * per_file + loading
+         + max_batch * per_segment + segment_frames;
+}
+
+MemoryPlan plan_memory(const ModelGeometry& geometry, size_t num_samples, size_t files_per_window, unsigned int threads, size_t max_batch, size_t budget_bytes) {
+
+    MemoryPlan plan;
+    plan.max_batch = std::max<size_t>(max_batch, 1);
+    plan.files_per_window = std::max<size_t>(files_per_window, 1);
+
+    size_t padded = num_samples + geometry.n_fft;
+    size_t per_file = 4 * padded * sizeof(float);
+    size_t per_segment = 3 * geometry.segment_values * sizeof(float) + geometry.activation_bytes_per_segment;
+
+    // shrink whichever of the file window and the batch currently costs more
+    plan.estimated_peak = estimate_peak_memory(geometry, num_samples, plan.files_per_window, threads, plan.max_batch);
+
+    while (plan.estimated_peak > budget_bytes && (plan.files_per_window > 1 || plan.max_batch > 1)) {
+        bool shrink_window = plan.max_batch == 1 ||
+            (plan.files_per_window > 1 && plan.files_per_window * per_file >= plan.max_batch * per_segment);
+
+        if (shrink_window) {
+            plan.files_per_window /= 2;
+        } else {
+            plan.max_batch /= 2;
+        }
+
+        plan.estimated_peak = estimate_peak_memory(geometry, num_samples, plan.files_per_window, threads, plan.max_batch);
+    }
+
+    plan.fits = plan.estimated_peak <= budget_bytes;
+    plan.concurrent_sessions = plan.fits ? budget_bytes / plan.estimated_peak : 0;
+
+    return plan;
+}
+
+static size_t read_status_field(const std::string& field) {
+
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size(), field) == 0) {
+            // e.g. "VmRSS:     123456 kB"
+            return std::stoull(line.substr(field.size() + 1)) * 1024;
+        }
+    }
+
+    return 0;
+}
+
+size_t current_memory_usage() {
+    return read_status_field("VmRSS");
+}
+
+size_t peak_memory_usage() {
+    return read_status_field("VmHWM");
+}
+
+bool reset_peak_memory_usage() {
+    // "5" resets the peak resident set size, linux 4.0+
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (!clear_refs) return false;
+    clear_refs << "5";
+    clear_refs.close();
+    return !clear_refs.fail();
+}
+
+void enforce_memory_budget(size_t budget_bytes, const std::string& stage) {
+
+    if (budget_bytes == 0) return;
+
+    // the high-water mark also catches spikes between checks, such as inside a model run
+    size_t peak = peak_memory_usage();
+    if (peak > budget_bytes) {
+        throw std::runtime_error("memory budget exceeded " + stage + ": peak of " + format_megabytes(peak) + ", budget " + format_megabytes(budget_bytes));
+    }
+}
+
+size_t parse_memory_size(const std::string& text) {
+
+    size_t consumed = 0;
+    double value = std::stod(text, &consumed);
+    std::string suffix = text.substr(consumed);
+
+    double scale;
+    if (suffix.empty() || suffix == "M" || suffix == "m" || suffix == "MB") scale = 1 << 20;
+    else if (suffix == "G" || suffix == "g" || suffix == "GB") scale = 1 << 30;
+    else if (suffix == "K" || suffix == "k" || suffix == "KB") scale = 1 << 10;
+    else throw std::runtime_error("unknown memory size suffix: " + suffix);
+
+    if (value <= 0) throw std::runtime_error("memory size must be positive: " + text);
+
+    return (size_t)(value * scale);
+}
+
+std::string format_megabytes(size_t bytes) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / (1024.0 * 1024.0));
+    return buffer;
+}
@@ -1,12 +1,29 @@
 #include "ModelHandler.h"
+#include "fp16.h"
 #include <iostream>
+#include <stdexcept>
+
+static bool supported_type(ONNXTensorElementDataType type) {
+    return type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT || type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+}
 
 void ModelHandler::load_model(const std::string& model_path) {
 
     try {
         model = std::make_unique<Ort::Session>(env, model_path.c_str(), config);
 
-        std::cout << "model loaded successfully: " << model_path << std::endl;
+        input_dims = model->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        input_type = model->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType();
+        output_type = model->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType();
+
+        if (!supported_type(input_type) || !supported_type(output_type)) {
+            std::cerr << "failed to load model: inputs and outputs must be float32 or float16" << std::endl;
+            model.reset();
+            input_dims.clear();
+            return;
+        }
+
+        std::cout << "model loaded successfully: " << model_path << " (" << io_precision() << " inputs/outputs)" << std::endl;
 
     } catch(const Ort::Exception& e) {
         std::cerr << "failed to load model: " << e.what() << std::endl;
@@ -23,10 +40,21 @@ std::vector<float> ModelHandler::run_inference(const std::vector<float>& input_d
 
     Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
 
-    Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
-        memory_info,
-        const_cast<float*>(input_data.data()), input_data.size(), input_shape.data(), input_shape.size()
-    );
+    // fp16 models get their input converted at the tensor boundary, everything else stays float
+    if (input_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+        _half_input.resize(input_data.size());
+        float_to_half(input_data.data(), _half_input.data(), input_data.size());
+    }
+
+    Ort::Value input_tensor = input_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16
+        ? Ort::Value::CreateTensor(
+            memory_info,
+            _half_input.data(), _half_input.size() * sizeof(uint16_t), input_shape.data(), input_shape.size(),
+            ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16)
+        : Ort::Value::CreateTensor<float>(
+            memory_info,
+            const_cast<float*>(input_data.data()), input_data.size(), input_shape.data(), input_shape.size()
+        );
 
     Ort::AllocatorWithDefaultOptions allocator;
 
@@ -45,10 +73,37 @@ std::vector<float> ModelHandler::run_inference(const std::vector<float>& input_d
         output_names, 1
     );
 
-    float* float_arr = output_tensors[0].GetTensorMutableData<float>();
-
     size_t output_size = output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount();
 
+    if (output_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+        std::vector<float> output(output_size);
+        half_to_float(output_tensors[0].GetTensorMutableData<uint16_t>(), output.data(), output_size);
+        return output;
+    }
+
+    float* float_arr = output_tensors[0].GetTensorMutableData<float>();
+
     return std::vector<float>(float_arr, float_arr + output_size);
 
 }
+
+std::string ModelHandler::io_precision() const {
+    return input_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16 ? "fp16" : "fp32";
+}
+
+std::string ModelHandler::variant_path(const std::string& model_path, const std::string& precision) {
+
+    if (precision == "fp32") return model_path;
+
+    if (precision != "fp16" && precision != "int8") {
+        throw std::runtime_error("unknown precision: " + precision + " (expected fp32, fp16 or int8)");
+    }
+
+    std::string base = model_path;
+    const std::string extension = ".onnx";
+    if (base.size() >= extension.size() && base.compare(base.size() - extension.size(), extension.size(), extension) == 0) {
+        base.erase(base.size() - extension.size());
+    }
+
+    return base + "." + precision + extension;
+}
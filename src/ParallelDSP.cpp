@@ -0,0 +1,174 @@
+#include "ParallelDSP.h"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+ParallelDSP::ParallelDSP(uint32_t n_fft, uint32_t hop_length, unsigned int num_threads)
+:n_fft(n_fft), hop_length(hop_length), num_threads(num_threads) {
+
+    if (this->num_threads == 0) {
+        this->num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    cores.reserve(this->num_threads);
+    for (unsigned int t = 0; t < this->num_threads; t++) {
+        cores.push_back(std::make_unique<DSPCore>(n_fft, hop_length));
+    }
+}
+
+void ParallelDSP::run_workers(unsigned int num_workers, const std::function<void(unsigned int)>& fn) {
+
+    std::vector<std::exception_ptr> errors(num_workers);
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+
+    for (unsigned int w = 1; w < num_workers; w++) {
+        workers.emplace_back([&, w]() {
+            try {
+                fn(w);
+            } catch (...) {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+
+    try {
+        fn(0);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+std::vector<size_t> ParallelDSP::plan_tiles(size_t num_frames, size_t min_frames) const {
+
+    size_t num_tiles = std::min<size_t>(num_threads, num_frames / std::max<size_t>(min_frames, 1));
+    num_tiles = std::max<size_t>(num_tiles, 1);
+
+    std::vector<size_t> bounds(num_tiles + 1);
+    for (size_t t = 0; t <= num_tiles; t++) {
+        bounds[t] = num_frames * t / num_tiles;
+    }
+
+    return bounds;
+}
+
+size_t ParallelDSP::frame_count(size_t padded_length) const {
+    if (padded_length < n_fft) return 0;
+    return (padded_length - n_fft) / hop_length + 1;
+}
+
+std::vector<std::vector<kiss_fft_cpx>> ParallelDSP::analyze(const std::vector<float>& padded) {
+    return analyze(padded, 0, frame_count(padded.size()));
+}
+
+std::vector<std::vector<kiss_fft_cpx>> ParallelDSP::analyze(const std::vector<float>& padded, size_t first_frame, size_t count) {
+
+    if (first_frame + count > frame_count(padded.size())) {
+        throw std::runtime_error("analysis range exceeds padded signal");
+    }
+
+    std::vector<std::vector<kiss_fft_cpx>> frames(count);
+
+    // every frame is independent, so plain contiguous chunks per thread
+    std::vector<size_t> bounds = plan_tiles(count, 1);
+
+    run_workers(bounds.size() - 1, [&](unsigned int t) {
+        DSPCore& dsp = *cores[t];
+        std::vector<float> frame(n_fft);
+
+        for (size_t k = bounds[t]; k < bounds[t + 1]; k++) {
+            size_t offset = (first_frame + k) * hop_length;
+
+            for (uint32_t i = 0; i < n_fft; i++) {
+                frame[i] = padded[offset + i];
+            }
+
+            frames[k] = dsp.stft(frame);
+        }
+    });
+
+    return frames;
+}
+
+void ParallelDSP::synthesize(const std::vector<std::vector<kiss_fft_cpx>>& frames, size_t first_frame, std::vector<float>& output) {
+
+    size_t num_frames = frames.size();
+    if (num_frames == 0) return;
+
+    if ((first_frame + num_frames - 1) * hop_length + n_fft > output.size()) {
+        throw std::runtime_error("synthesis range exceeds output buffer");
+    }
+
+    // a tile must be at least one frame long so spill only ever reaches the next tile
+    size_t min_frames = (n_fft + hop_length - 1) / hop_length;
+    std::vector<size_t> bounds = plan_tiles(num_frames, min_frames);
+    size_t num_tiles = bounds.size() - 1;
+
+    auto tile_start = [&](size_t t) { return (first_frame + bounds[t]) * hop_length; };
+    auto tile_end = [&](size_t t) {
+        if (t + 1 < num_tiles) return tile_start(t + 1);
+        return (first_frame + num_frames - 1) * hop_length + n_fft;
+    };
+
+    // time-domain frames that spill past the end of their tile, and the index of the first one
+    std::vector<std::vector<std::vector<float>>> edge_frames(num_tiles);
+    std::vector<size_t> edge_first(num_tiles, 0);
+
+    // pass 1: each tile transforms its boundary frames once and keeps them for both owners
+    run_workers(num_tiles, [&](unsigned int t) {
+        if (t + 1 == num_tiles) return;
+
+        size_t end = tile_end(t);
+        size_t k = bounds[t + 1];
+        while (k > bounds[t] && (first_frame + k - 1) * hop_length + n_fft > end) k--;
+
+        edge_first[t] = k;
+        for (; k < bounds[t + 1]; k++) {
+            edge_frames[t].push_back(cores[t]->istft(frames[k]));
+        }
+    });
+
+    // pass 2: each tile adds the previous tile's spill, then its own frames, in frame order
+    // so every sample receives its contributions in exactly the serial order
+    run_workers(num_tiles, [&](unsigned int t) {
+        size_t start = tile_start(t);
+        size_t end = tile_end(t);
+
+        if (t > 0) {
+            for (size_t e = 0; e < edge_frames[t - 1].size(); e++) {
+                const std::vector<float>& time = edge_frames[t - 1][e];
+                size_t offset = (first_frame + edge_first[t - 1] + e) * hop_length;
+
+                for (size_t n = start - offset; n < n_fft; n++) {
+                    output[offset + n] += time[n];
+                }
+            }
+        }
+
+        for (size_t k = bounds[t]; k < bounds[t + 1]; k++) {
+            size_t offset = (first_frame + k) * hop_length;
+            size_t limit = std::min<size_t>(n_fft, end - offset);
+
+            if (t + 1 < num_tiles && k >= edge_first[t]) {
+                const std::vector<float>& time = edge_frames[t][k - edge_first[t]];
+                for (size_t n = 0; n < limit; n++) {
+                    output[offset + n] += time[n];
+                }
+            } else {
+                const std::vector<float>& time = cores[t]->istft(frames[k]);
+                for (size_t n = 0; n < limit; n++) {
+                    output[offset + n] += time[n];
+                }
+            }
+        }
+    });
+}
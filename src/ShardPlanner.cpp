@@ -0,0 +1,86 @@
+#include "ShardPlanner.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+std::vector<Shard> plan_shards(size_t num_samples, size_t num_shards, const ShardConfig& config) {
+
+    if (config.segment_samples == 0 || 2 * config.margin + config.crossfade > config.segment_samples) {
+        throw std::runtime_error("crossfade and margins must fit inside one segment");
+    }
+
+    size_t num_units = (num_samples + config.segment_samples - 1) / config.segment_samples;
+    num_shards = std::max<size_t>(1, std::min(num_shards, num_units));
+
+    // core boundaries on the segment grid
+    std::vector<size_t> bounds(num_shards + 1);
+    for (size_t i = 0; i < num_shards; i++) {
+        bounds[i] = (num_units * i / num_shards) * config.segment_samples;
+    }
+    bounds[num_shards] = num_samples;
+
+    std::vector<Shard> shards(num_shards);
+
+    for (size_t i = 0; i < num_shards; i++) {
+        Shard& shard = shards[i];
+
+        if (i == 0) {
+            shard.read_start = 0;
+            shard.fade_in_start = shard.fade_in_end = 0;
+        } else {
+            // one segment of lead-in: the first segment sees reflect padding and is faded out of the result
+            shard.read_start = bounds[i] - config.segment_samples;
+            shard.fade_in_start = std::min(num_samples, bounds[i] + config.margin);
+            shard.fade_in_end = std::min(num_samples, shard.fade_in_start + config.crossfade);
+        }
+
+        if (i + 1 == num_shards) {
+            shard.read_end = num_samples;
+            shard.fade_out_start = shard.fade_out_end = num_samples;
+        } else {
+            // one segment plus margin of lead-out so the segment after the boundary is complete
+            shard.read_end = std::min(num_samples, bounds[i + 1] + config.segment_samples + config.margin);
+            shard.fade_out_start = std::min(num_samples, bounds[i + 1] + config.margin);
+            shard.fade_out_end = std::min(num_samples, shard.fade_out_start + config.crossfade);
+        }
+    }
+
+    return shards;
+}
+
+std::vector<float> merge_shards(const std::vector<Shard>& shards, const std::vector<std::vector<float>>& outputs, size_t num_samples) {
+
+    if (shards.size() != outputs.size()) {
+        throw std::runtime_error("expected one output per shard");
+    }
+
+    std::vector<float> merged(num_samples * 2, 0.0f);
+
+    for (size_t s = 0; s < shards.size(); s++) {
+        const Shard& shard = shards[s];
+        const std::vector<float>& output = outputs[s];
+
+        if (output.size() < (shard.read_end - shard.read_start) * 2) {
+            throw std::runtime_error("shard " + std::to_string(s) + " output is shorter than its input range");
+        }
+
+        size_t begin = std::max(shard.read_start, shard.fade_in_start);
+        size_t end = std::min(shard.read_end, shard.fade_out_end);
+
+        for (size_t p = begin; p < end; p++) {
+            // linear ramps; a fade out mirrors the neighbour's fade in so the weights sum to one
+            float weight = 1.0f;
+            if (p < shard.fade_in_end) {
+                weight = (p - shard.fade_in_start + 0.5f) / (shard.fade_in_end - shard.fade_in_start);
+            } else if (p >= shard.fade_out_start) {
+                weight = 1.0f - (p - shard.fade_out_start + 0.5f) / (shard.fade_out_end - shard.fade_out_start);
+            }
+
+            size_t local = p - shard.read_start;
+            merged[p * 2] += weight * output[local * 2];
+            merged[p * 2 + 1] += weight * output[local * 2 + 1];
+        }
+    }
+
+    return merged;
+}
@@ -0,0 +1,140 @@
+#include "fp16.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FP16_HAVE_F16C_PATH 1
+#include <immintrin.h>
+#endif
+
+uint16_t float_to_half(float value) {
+
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    // nan and inf, keeping nans quiet
+    if (exponent == 0xff) {
+        return sign | 0x7c00 | (mantissa ? 0x200 | (mantissa >> 13) : 0);
+    }
+
+    int32_t half_exponent = (int32_t)exponent - 127 + 15;
+
+    // too large: round to inf
+    if (half_exponent >= 0x1f) {
+        return sign | 0x7c00;
+    }
+
+    // subnormal or zero in half precision
+    if (half_exponent <= 0) {
+        if (half_exponent < -10) return sign;
+
+        mantissa |= 0x800000;
+        uint32_t shift = 14 - half_exponent;
+        uint32_t half_mantissa = mantissa >> shift;
+
+        // round to nearest even
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half_mantissa & 1))) half_mantissa++;
+
+        return sign | half_mantissa;
+    }
+
+    uint32_t half = sign | (half_exponent << 10) | (mantissa >> 13);
+
+    // round to nearest even, a carry into the exponent is still correct (up to inf)
+    uint32_t remainder = mantissa & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+
+    return half;
+}
+
+float half_to_float(uint16_t value) {
+
+    uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0x1f) {
+        // inf, or a nan made quiet like the hardware conversion does
+        bits = sign | 0x7f800000 | (mantissa << 13) | (mantissa ? 0x400000 : 0);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // subnormal half, normalize it
+        exponent = 127 - 15 + 1;
+        while ((mantissa & 0x400) == 0) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+#ifdef FP16_HAVE_F16C_PATH
+
+__attribute__((target("avx,f16c")))
+static void float_to_half_f16c(const float* input, uint16_t* output, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 values = _mm256_loadu_ps(input + i);
+        __m128i halves = _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), halves);
+    }
+    for (; i < count; i++) {
+        output[i] = float_to_half(input[i]);
+    }
+}
+
+__attribute__((target("avx,f16c")))
+static void half_to_float_f16c(const uint16_t* input, float* output, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm256_storeu_ps(output + i, _mm256_cvtph_ps(halves));
+    }
+    for (; i < count; i++) {
+        output[i] = half_to_float(input[i]);
+    }
+}
+
+static bool cpu_has_f16c() {
+    static const bool supported = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    return supported;
+}
+
+#endif
+
+void float_to_half(const float* input, uint16_t* output, size_t count) {
+#ifdef FP16_HAVE_F16C_PATH
+    if (cpu_has_f16c()) {
+        float_to_half_f16c(input, output, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        output[i] = float_to_half(input[i]);
+    }
+}
+
+void half_to_float(const uint16_t* input, float* output, size_t count) {
+#ifdef FP16_HAVE_F16C_PATH
+    if (cpu_has_f16c()) {
+        half_to_float_f16c(input, output, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        output[i] = half_to_float(input[i]);
+    }
+}
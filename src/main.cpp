@@ -4,7 +4,14 @@
 #include <cstdlib>
 #include <cstdio>
 #include <ctime>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include "BatchScheduler.h"
 #include "DSPCore.h"
+#include "MemoryPlanner.h"
+#include "ParallelDSP.h"
+#include "ShardPlanner.h"
 #include "kiss_fft.h"
 #include "ModelHandler.h"
 #include "WAVHeader.h"
@@ -13,7 +20,12 @@
 #include <cmath>
 
 std::string preprocess_input(const std::string& input_path, bool& needs_cleanup) {
-    std::srand(std::time(nullptr));
+    // seed once, reseeding within the same second would repeat temp names across files
+    static bool seeded = false;
+    if (!seeded) {
+        std::srand(std::time(nullptr));
+        seeded = true;
+    }
     std::string temp_path = "temp_input_" + std::to_string(std::rand()) + ".wav";
 
     // Construct ffmpeg command
@@ -74,159 +86,502 @@ void apply_noise_gate(std::vector<float>& stereo_audio, float threshold_db = -60
 
 }
 
-void run_seperation(const std::string& input_path, const std::string& output_path, const std::string& model_path) {
-    // setup
-    std::cout << "loading " << input_path << "..." << std::endl;
-    std::vector<float> stereo_buffer;
-    WAVHeader header = read_wav(input_path, stereo_buffer);
-std::cout << "DEBUG: stereo buffer size: " << stereo_buffer.size() << std::endl;
+struct SeparationJob {
+    std::string input_path;   // as given, converted with ffmpeg when it is loaded unless preprocessing is off
+    std::string output_path;
+};
+
+// a job's input once its window has been converted, temp wavs are removed when the window is done
+struct PreparedInput {
+    size_t job;
+    std::string wav_path;
+    bool needs_cleanup;
+    size_t num_samples;
+};
+
+void remove_temp_inputs(const std::vector<PreparedInput>& inputs) {
+    for (const PreparedInput& input : inputs) {
+        if (input.needs_cleanup) std::remove(input.wav_path.c_str());
+    }
+}
+
+struct SeparationOptions {
+    std::string model_path = "models/UVR_MDXNET_KARA_2.onnx";
+    unsigned int threads = 0;        // 0 = all hardware threads
+    size_t files_per_window = 64;    // files loaded and packed together at once
+    SchedulerConfig scheduler;
+    size_t shards = 0;               // > 1 splits the input across worker processes
+    std::string shard_dir;           // where shard wavs are exchanged, default <output>.shards
+    size_t max_memory = 0;           // bytes for the whole job, 0 = unlimited
+    size_t activation_memory = 0;    // onnx runtime bytes per segment, 0 = measure it when planning under a budget
+    bool preprocess = true;          // convert inputs with ffmpeg, a window at a time
+};
+
+ModelGeometry model_geometry(const SeparationOptions& options) {
+    ModelGeometry geometry;
+    std::error_code error;
+    size_t model_bytes = std::filesystem::file_size(options.model_path, error);
+    if (!error) geometry.model_bytes = model_bytes;
+    if (options.activation_memory > 0) geometry.activation_bytes_per_segment = options.activation_memory;
+    return geometry;
+}
+
+// sets the geometry's activation memory to what one silent batch-1 segment adds to the peak on top
+// of what is already resident. keeps the default where the peak cannot be reset
+void measure_activation_memory(ModelHandler& model, ModelGeometry& geometry) {
+
+    std::vector<float> tensor(geometry.segment_values, 0.0f);
+    std::vector<int64_t> input_shape = {1, 4, 2048, (int64_t)geometry.segment_frames};
+
+    if (!reset_peak_memory_usage()) {
+        std::cout << "could not measure model working memory, assuming " << format_megabytes(geometry.activation_bytes_per_segment) << " per segment" << std::endl;
+        return;
+    }
+
+    size_t before = current_memory_usage();
+    model.run_inference(tensor, input_shape);
+    size_t peak = peak_memory_usage();
 
-    // split channels
+    // the output and its returned copy are counted by the estimate separately
+    size_t tensors = 2 * geometry.segment_values * sizeof(float);
+    geometry.activation_bytes_per_segment = peak > before + tensors ? peak - before - tensors : 0;
+
+    std::cout << "measured model working memory: " << format_megabytes(geometry.activation_bytes_per_segment) << " per segment" << std::endl;
+}
+
+// turns the scheduler's overlap-added output of one file into the final stereo wav
+void finish_output(WAVHeader& header, const std::string& output_path, const std::vector<float>& left_reconstructed, const std::vector<float>& right_reconstructed, size_t num_samples, uint32_t pad_length) {
+
+    std::vector<float> stereo_output;
+    stereo_output.reserve(num_samples * 2);
+
+    for (size_t i = 0; i < num_samples; i++) {
+        stereo_output.push_back(left_reconstructed[pad_length + i]);
+        stereo_output.push_back(right_reconstructed[pad_length + i]);
+    }
+
+    // normalization for COLA (Constant Overlap-Add):
+    // with window applied in both stft and istft (symmetric), we have w^2(n) at each position.
+    // For 75% overlap (hop_length = n_fft/4) with periodic hann window:
+    // sum of squared windows at each position = 1.5
+    // So we divide by 1.5 to normalize
 
-    std::vector<float> left_audio, right_audio;
-    for (size_t i = 0; i < stereo_buffer.size(); i += 2) {
-        left_audio.push_back(stereo_buffer[i]);
-        right_audio.push_back(stereo_buffer[i + 1]);
+    for (float& sample : stereo_output) {
+        sample /= 1.5f;
     }
 
+    apply_noise_gate(stereo_output, -40.0f, 2048);
+
+
+    write_wav(header, output_path, stereo_output);
+}
+
+// returns the number of files that were skipped because they could not be read or written
+size_t run_seperation(const std::vector<SeparationJob>& jobs, const SeparationOptions& options) {
+    // setup
     uint32_t n_fft = 4096; uint32_t hop_length = 1024;  // 75% overlap
+    uint32_t pad_length = n_fft / 2;
 
     DSPCore dsp(n_fft, hop_length);
+    ParallelDSP parallel_dsp(n_fft, hop_length, options.threads);
     ModelHandler model;
-    model.load_model(model_path);
+    model.load_model(options.model_path);
+
+    SchedulerStats totals;
+    ModelGeometry geometry = model_geometry(options);
+    size_t batch = model.supports_batching() ? options.scheduler.max_batch : 1;
 
-    // analysis
+    // measuring resets the peak, keep what loading reached for the final report
+    size_t loading_peak = peak_memory_usage();
+    if (options.max_memory > 0 && options.activation_memory == 0) {
+        measure_activation_memory(model, geometry);
+    }
+
+    // the estimate is printed next to the measured peak at the end, budget or not, so it can be calibrated
+    size_t estimated_peak = 0;
+    size_t failed = 0;
 
-    std::vector<float> left_padded = dsp.pad_audio(left_audio);
-    std::vector<float> right_padded = dsp.pad_audio(right_audio);
+    auto skip = [&failed](const SeparationJob& job, const std::exception& e) {
+        std::cerr << "skipping " << job.input_path << ": " << e.what() << std::endl;
+        failed++;
+    };
 
+    // files are converted and loaded a window at a time so memory and temp files stay bounded
+    // on large job lists, segments of all files in a window are packed together
+    size_t window = std::max<size_t>(options.files_per_window, 1);
 
-    std::vector<std::vector<kiss_fft_cpx>> all_left_frames, all_right_frames;
+    for (size_t window_start = 0; window_start < jobs.size(); window_start += window) {
+        size_t window_end = std::min(jobs.size(), window_start + window);
 
+        std::vector<PreparedInput> inputs;
 
-    for (size_t offset = 0; offset + n_fft <= left_padded.size(); offset += hop_length) {
-        std::vector<float> left_frame(n_fft), right_frame(n_fft);
+        for (size_t j = window_start; j < window_end; j++) {
+            PreparedInput input = {j, jobs[j].input_path, false, 0};
+            if (options.preprocess) input.wav_path = preprocess_input(jobs[j].input_path, input.needs_cleanup);
 
-        for (uint32_t i = 0; i < n_fft; i++) {
-            left_frame[i] = left_padded[offset + i];
-            right_frame[i] = right_padded[offset + i];
+            try {
+                input.num_samples = wav_frame_count(input.wav_path);
+                inputs.push_back(input);
+            } catch (const std::exception& e) {
+                skip(jobs[j], e);
+                if (input.needs_cleanup) std::remove(input.wav_path.c_str());
+            }
         }
 
-        all_left_frames.push_back(dsp.stft(left_frame));
-        all_right_frames.push_back(dsp.stft(right_frame));
+        try {
+            size_t longest = 0;
+            for (const PreparedInput& input : inputs) longest = std::max(longest, input.num_samples);
 
-    }
+            // the budget may split the window into smaller groups and lower the batch
+            SchedulerConfig scheduler_config = options.scheduler;
+            scheduler_config.memory_budget = options.max_memory;
+            size_t group = std::max<size_t>(inputs.size(), 1);
+            size_t window_peak = estimate_peak_memory(geometry, longest, group, parallel_dsp.threads(), batch);
 
-    std::vector<std::vector<kiss_fft_cpx>> processed_left, processed_right;
+            if (options.max_memory > 0 && !inputs.empty()) {
+                MemoryPlan plan = plan_memory(geometry, longest, group, parallel_dsp.threads(), batch, options.max_memory);
 
-    int batch_size = 256;
-    int num_frames = all_left_frames.size();
+                std::cout << "memory plan: batch " << plan.max_batch << ", " << plan.files_per_window << " file(s) per window, estimated peak "
+                          << format_megabytes(plan.estimated_peak) << " of " << format_megabytes(options.max_memory) << ", "
+                          << plan.concurrent_sessions << " separator process(es) of this shape fit in the budget" << std::endl;
 
-    std::cout << "runnning inference on " << num_frames << " frames..." << std::endl;
+                if (!plan.fits) {
+                    throw std::runtime_error("input does not fit in the memory budget (needs about " + format_megabytes(plan.estimated_peak) +
+                                             " at batch 1), raise --max-memory");
+                }
 
-    std::vector<int64_t> input_shape = {1, 4, 2048, 256};
+                scheduler_config.max_batch = plan.max_batch;
+                group = plan.files_per_window;
+                window_peak = plan.estimated_peak;
+            }
+            estimated_peak = std::max(estimated_peak, window_peak);
+
+            for (size_t group_start = 0; group_start < inputs.size(); group_start += group) {
+                size_t group_end = std::min(inputs.size(), group_start + group);
+
+                BatchScheduler scheduler(model, parallel_dsp, scheduler_config);
+                std::vector<const PreparedInput*> loaded;
+                std::vector<WAVHeader> headers;
+                std::vector<size_t> lengths;
+
+                for (size_t i = group_start; i < group_end; i++) {
+                    const SeparationJob& job = jobs[inputs[i].job];
+                    std::cout << "loading " << job.input_path << "..." << std::endl;
+
+                    try {
+                        std::vector<float> stereo_buffer;
+                        WAVHeader header = read_wav(inputs[i].wav_path, stereo_buffer);
+
+                        // split channels
+
+                        std::vector<float> left_audio, right_audio;
+                        left_audio.reserve(stereo_buffer.size() / 2);
+                        right_audio.reserve(stereo_buffer.size() / 2);
+                        for (size_t k = 0; k < stereo_buffer.size(); k += 2) {
+                            left_audio.push_back(stereo_buffer[k]);
+                            right_audio.push_back(stereo_buffer[k + 1]);
+                        }
+                        std::vector<float>().swap(stereo_buffer);
+
+                        scheduler.add_file(dsp.pad_audio(left_audio), dsp.pad_audio(right_audio));
+                        loaded.push_back(&inputs[i]);
+                        headers.push_back(header);
+                        lengths.push_back(left_audio.size());
+                    } catch (const std::exception& e) {
+                        skip(job, e);
+                    }
+
+                    enforce_memory_budget(options.max_memory, "while loading " + job.input_path);
+                }
+
+                if (loaded.empty()) continue;
+
+                std::cout << "running inference on " << loaded.size() << " file(s)..." << std::endl;
+                scheduler.run();
+
+                for (size_t f = 0; f < loaded.size(); f++) {
+                    const SeparationJob& job = jobs[loaded[f]->job];
+
+                    std::vector<float> left_reconstructed, right_reconstructed;
+                    scheduler.take_output(f, left_reconstructed, right_reconstructed);
+
+                    try {
+                        finish_output(headers[f], job.output_path, left_reconstructed, right_reconstructed, lengths[f], pad_length);
+                        std::cout << "saved " << job.output_path << std::endl;
+                    } catch (const std::exception& e) {
+                        skip(job, e);
+                    }
+                }
+
+                const SchedulerStats& stats = scheduler.get_stats();
+                totals.files += stats.files;
+                totals.runs += stats.runs;
+                totals.segments += stats.segments;
+                totals.useful_frames += stats.useful_frames;
+                totals.padded_frames += stats.padded_frames;
+            }
+        } catch (...) {
+            remove_temp_inputs(inputs);
+            throw;
+        }
+        remove_temp_inputs(inputs);
+    }
 
-    for (int i = 0; i < num_frames; i += batch_size) {
+    std::cout << totals.files << " file(s), " << totals.segments << " segment(s) in " << totals.runs << " run(s), "
+              << totals.padded_frames << " of " << totals.useful_frames + totals.padded_frames << " frames were padding" << std::endl;
+    std::cout << "peak memory: " << format_megabytes(std::max(loading_peak, peak_memory_usage())) << " measured, " << format_megabytes(estimated_peak) << " estimated" << std::endl;
 
-        std::vector<std::vector<kiss_fft_cpx>> left_batch(batch_size, std::vector<kiss_fft_cpx>(n_fft)), right_batch(batch_size, std::vector<kiss_fft_cpx>(n_fft));
+    if (failed > 0) {
+        std::cerr << failed << " of " << jobs.size() << " file(s) skipped" << std::endl;
+    }
+    return failed;
+}
 
-        int frames_remaining = num_frames - i;
-        int actual_batch = std::min(batch_size, frames_remaining);
+void set_sample_count(WAVHeader& header, size_t num_values) {
+    header.subchunk2_size = num_values * sizeof(float);
+    header.chunk_size = 36 + header.subchunk2_size;
+}
 
-        for (int j = 0; j < actual_batch; j++) {
-            left_batch[j] = all_left_frames[i + j];
-            right_batch[j] = all_right_frames[i + j];
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// splits one long input into overlapping time ranges, runs each range in its own
+// separator process and crossfades the results back together.
+// shard files go through options.shard_dir, which may be on a shared filesystem.
+void run_sharded(const SeparationJob& job, const SeparationOptions& options, const std::string& executable) {
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::cout << "loading " << job.input_path << "..." << std::endl;
+    std::vector<float> stereo_buffer;
+    WAVHeader header = read_wav(job.input_path, stereo_buffer);
+    size_t num_samples = stereo_buffer.size() / 2;
+
+    std::vector<Shard> shards = plan_shards(num_samples, options.shards);
+
+    // workers share the machine's cores unless told otherwise
+    auto threads_per_worker = [&options](size_t workers) {
+        if (options.threads > 0) return options.threads;
+        return std::max<unsigned int>(1, std::thread::hardware_concurrency() / workers);
+    };
+
+    // the workers run side by side and split the budget, so use fewer (larger) shards until they fit.
+    // the coordinator itself only holds audio before and after the workers run.
+    size_t worker_budget = 0;
+    size_t worker_activation = 0;
+    if (options.max_memory > 0) {
+        if (num_samples * 2 * 2 * sizeof(float) > options.max_memory) {
+            throw std::runtime_error("merging this input needs more than " + format_megabytes(options.max_memory));
         }
 
-        std::vector<float> tensor = stft_to_tensor(left_batch, right_batch);
+        ModelGeometry geometry = model_geometry(options);
+        if (options.activation_memory == 0) {
+            // measured once here and handed to the workers so they do not each repeat it
+            ModelHandler model;
+            model.load_model(options.model_path);
+            measure_activation_memory(model, geometry);
+        }
+        worker_activation = geometry.activation_bytes_per_segment;
 
-        std::vector<float> processed = model.run_inference(tensor, input_shape);
+        while (true) {
+            size_t longest = 0;
+            for (const Shard& shard : shards) longest = std::max(longest, shard.read_end - shard.read_start);
 
-        auto output = tensor_to_stft(processed);
+            size_t worker_peak = estimate_peak_memory(geometry, longest, 1, threads_per_worker(shards.size()), 1);
+            if (worker_peak * shards.size() <= options.max_memory) break;
 
-        for (int k = 0; k < actual_batch; k++) {
-            processed_left.push_back(output.first[k]);
-            processed_right.push_back(output.second[k]);
+            if (shards.size() == 1) {
+                throw std::runtime_error("a single worker needs about " + format_megabytes(worker_peak) + ", more than --max-memory allows");
+            }
+            shards = plan_shards(num_samples, shards.size() - 1);
         }
 
+        worker_budget = options.max_memory / shards.size();
+        std::cout << "memory plan: " << shards.size() << " worker(s) with " << format_megabytes(worker_budget) << " each" << std::endl;
     }
 
-    std::vector<float> left_reconstructed(left_padded.size(), 0.0f);
-    std::vector<float> right_reconstructed(right_padded.size(), 0.0f);
+    // counted for the final number of shards, which the budget may have lowered
+    unsigned int worker_threads = threads_per_worker(shards.size());
 
-    uint32_t pad_length = n_fft / 2;
-    for (size_t frame_idx = 0; frame_idx < processed_left.size(); frame_idx++) {
-        std::vector<float> left_time = dsp.istft(processed_left[frame_idx]);
-        std::vector<float> right_time = dsp.istft(processed_right[frame_idx]);
+    std::string shard_dir = options.shard_dir.empty() ? job.output_path + ".shards" : options.shard_dir;
+    std::filesystem::create_directories(shard_dir);
 
-        size_t offset = frame_idx * hop_length;
+    std::vector<std::string> shard_inputs, shard_outputs;
 
-        for (uint32_t n = 0; n < n_fft; n++) {
-            left_reconstructed[offset + n] += left_time[n];
-            right_reconstructed[offset + n] += right_time[n];
-        }
+    for (size_t s = 0; s < shards.size(); s++) {
+        shard_inputs.push_back(shard_dir + "/shard_" + std::to_string(s) + ".wav");
+        shard_outputs.push_back(shard_dir + "/shard_" + std::to_string(s) + "_out.wav");
+
+        std::vector<float> slice(stereo_buffer.begin() + shards[s].read_start * 2, stereo_buffer.begin() + shards[s].read_end * 2);
 
+        WAVHeader shard_header = header;
+        set_sample_count(shard_header, slice.size());
+        write_wav(shard_header, shard_inputs[s], slice);
     }
 
-    std::vector<float> left_final(left_audio.size());
-    std::vector<float> right_final(right_audio.size());
+    std::vector<float>().swap(stereo_buffer);
+    double split_time = seconds_since(start);
+
+    std::cout << "launching " << shards.size() << " worker(s)..." << std::endl;
+    auto workers_start = std::chrono::steady_clock::now();
+
+    std::vector<int> status(shards.size(), 0);
+    std::vector<std::thread> workers;
+
+    for (size_t s = 0; s < shards.size(); s++) {
+        std::string cmd = "\"" + executable + "\" --no-preprocess "
+                          "--model \"" + options.model_path + "\" "
+                          "--threads " + std::to_string(worker_threads) + " "
+                          "--batch " + std::to_string(options.scheduler.max_batch) + " " +
+                          (worker_budget > 0 ? "--max-memory " + std::to_string(worker_budget / 1024) + "K "
+                                               "--activation-memory " + std::to_string(std::max<size_t>(worker_activation / 1024, 1)) + "K " : "") +
+                          "\"" + shard_inputs[s] + "\" \"" + shard_outputs[s] + "\" "
+                          "> \"" + shard_dir + "/shard_" + std::to_string(s) + ".log\" 2>&1";
 
-    for (size_t i = 0; i < left_audio.size(); i++) {
-        left_final[i] = left_reconstructed[pad_length + i];
-        right_final[i] = right_reconstructed[pad_length + i];
+        workers.emplace_back([&status, s, cmd]() {
+            status[s] = std::system(cmd.c_str());
+        });
     }
 
-    std::vector<float> stereo_output;
-    stereo_output.reserve(left_final.size() * 2);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
 
-    for (size_t i = 0; i < left_final.size(); i++) {
-        stereo_output.push_back(left_final[i]);
-        stereo_output.push_back(right_final[i]);
+    for (size_t s = 0; s < shards.size(); s++) {
+        if (status[s] != 0) {
+            throw std::runtime_error("worker for shard " + std::to_string(s) + " failed, see " + shard_dir + "/shard_" + std::to_string(s) + ".log");
+        }
     }
 
-    // normalization for COLA (Constant Overlap-Add):
-    // with window applied in both stft and istft (symmetric), we have w^2(n) at each position.
-    // For 75% overlap (hop_length = n_fft/4) with periodic hann window:
-    // sum of squared windows at each position = 1.5
-    // So we divide by 1.5 to normalize
+    double workers_time = seconds_since(workers_start);
+    auto merge_start = std::chrono::steady_clock::now();
 
-    for (float& sample : stereo_output) {
-        sample /= 1.5f;
+    std::vector<std::vector<float>> outputs(shards.size());
+    for (size_t s = 0; s < shards.size(); s++) {
+        read_wav(shard_outputs[s], outputs[s]);
     }
 
-    apply_noise_gate(stereo_output, -40.0f, 2048);
+    std::vector<float> merged = merge_shards(shards, outputs, num_samples);
 
+    set_sample_count(header, merged.size());
+    write_wav(header, job.output_path, merged);
 
-    write_wav(header, output_path, stereo_output);
+    double merge_time = seconds_since(merge_start);
+
+    for (size_t s = 0; s < shards.size(); s++) {
+        std::filesystem::remove(shard_inputs[s]);
+        std::filesystem::remove(shard_outputs[s]);
+        std::filesystem::remove(shard_dir + "/shard_" + std::to_string(s) + ".log");
+    }
+    if (options.shard_dir.empty()) std::filesystem::remove(shard_dir);
+
+    double total_time = seconds_since(start);
+
+    std::cout << shards.size() << " shard(s): split " << split_time << " s, workers " << workers_time
+              << " s, merge " << merge_time << " s (" << 100.0 * (split_time + merge_time) / total_time
+              << "% of " << total_time << " s spent outside the workers)" << std::endl;
+    std::cout << "coordinator peak memory: " << format_megabytes(peak_memory_usage()) << std::endl;
+}
+
+void print_usage() {
+    std::cout << "usage: ./seperator [options] <input> <output.wav> [<input> <output.wav> ...]" << std::endl;
+    std::cout << "  --model <path>     onnx model (default models/UVR_MDXNET_KARA_2.onnx)" << std::endl;
+    std::cout << "  --precision <p>    fp32 (default), fp16 or int8: use the model.<p>.onnx variant next to --model" << std::endl;
+    std::cout << "  --threads <n>      dsp worker threads (default: all cores)" << std::endl;
+    std::cout << "  --batch <n>        segments per model run when the model allows it (default 4)" << std::endl;
+    std::cout << "  --window <n>       files packed together at once (default 64)" << std::endl;
+    std::cout << "  --pack-tails       let files share a segment for their last frames (faster, approximate)" << std::endl;
+    std::cout << "  --guard-frames <n> silent frames between packed tails (default 8)" << std::endl;
+    std::cout << "  --shards <n>       split a single long input across n worker processes" << std::endl;
+    std::cout << "  --shard-dir <dir>  directory for shard files (default <output>.shards)" << std::endl;
+    std::cout << "  --max-memory <n>   memory budget, e.g. 2G or 512M; picks batch/window/shards to fit and aborts if exceeded" << std::endl;
+    std::cout << "  --activation-memory <n>  model working memory per segment for the plan (default: measured under --max-memory)" << std::endl;
+    std::cout << "  --no-preprocess    read the input wav directly instead of converting with ffmpeg" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 3) {
-        std::cout << "usage: ./seperator <input.wav> <output.wav>" << std::endl;
+    SeparationOptions options;
+    std::vector<std::string> paths;
+    std::string precision = "fp32";
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if (arg.rfind("--", 0) != 0) {
+                paths.push_back(arg);
+            } else if (arg == "--pack-tails") {
+                options.scheduler.pack_tails = true;
+            } else if (arg == "--no-preprocess") {
+                options.preprocess = false;
+            } else if (i + 1 < argc && arg == "--model") {
+                options.model_path = argv[++i];
+            } else if (i + 1 < argc && arg == "--precision") {
+                precision = argv[++i];
+            } else if (i + 1 < argc && arg == "--threads") {
+                options.threads = std::stoul(argv[++i]);
+            } else if (i + 1 < argc && arg == "--batch") {
+                options.scheduler.max_batch = std::stoul(argv[++i]);
+            } else if (i + 1 < argc && arg == "--guard-frames") {
+                options.scheduler.guard_frames = std::stoul(argv[++i]);
+            } else if (i + 1 < argc && arg == "--window") {
+                options.files_per_window = std::stoul(argv[++i]);
+            } else if (i + 1 < argc && arg == "--shards") {
+                options.shards = std::stoul(argv[++i]);
+            } else if (i + 1 < argc && arg == "--max-memory") {
+                options.max_memory = parse_memory_size(argv[++i]);
+            } else if (i + 1 < argc && arg == "--activation-memory") {
+                options.activation_memory = parse_memory_size(argv[++i]);
+            } else if (i + 1 < argc && arg == "--shard-dir") {
+                options.shard_dir = argv[++i];
+            } else {
+                std::cerr << "unknown option: " << arg << std::endl;
+                print_usage();
+                return 1;
+            }
+        }
+
+        options.model_path = ModelHandler::variant_path(options.model_path, precision);
+
+    } catch (const std::exception& e) {
+        std::cerr << "invalid option value: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (paths.size() < 2 || paths.size() % 2 != 0 || (options.shards > 1 && paths.size() != 2)) {
+        print_usage();
         return 1;
     }
 
-    std::string input_file = argv[1];
-    std::string output_file = argv[2];
-    std::string model_file = "models/UVR_MDXNET_KARA_2.onnx";
+    std::vector<SeparationJob> jobs;
+    for (size_t i = 0; i < paths.size(); i += 2) {
+        jobs.push_back({paths[i], paths[i + 1]});
+    }
 
-    bool needs_cleanup = false;
-    std::string processed_file = preprocess_input(input_file, needs_cleanup);
+    int status = 0;
 
     try {
-        run_seperation(processed_file, output_file, model_file);
-        std::cout << "done! saved to " << output_file << std::endl;
+        if (options.shards > 1) {
+            bool needs_cleanup = false;
+            SeparationJob job = jobs[0];
+            if (options.preprocess) job.input_path = preprocess_input(job.input_path, needs_cleanup);
+
+            try {
+                run_sharded(job, options, argv[0]);
+            } catch (...) {
+                if (needs_cleanup) std::remove(job.input_path.c_str());
+                throw;
+            }
+            if (needs_cleanup) std::remove(job.input_path.c_str());
+        } else if (run_seperation(jobs, options) > 0) {
+            status = 1;
+        }
+        std::cout << "done!" << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "error: " << e.what() << std::endl;
-        if (needs_cleanup) {
-            std::remove(processed_file.c_str());
-        }
-        return 1;
-    }
-
-    if (needs_cleanup) {
-        std::remove(processed_file.c_str());
+        status = 1;
     }
 
-    return 0;
+    return status;
 }
@@ -0,0 +1,162 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include "BatchScheduler.h"
+#include "DSPCore.h"
+#include "ModelHandler.h"
+#include "ParallelDSP.h"
+
+// throughput of per-file processing vs cross-file batching and tail packing on a synthetic
+// corpus of short clips, plus how far each mode's output is from the per-file output
+// usage: ./batch_scheduler_bench [model.onnx] [num_clips] [guard_frames]
+
+struct Clip {
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+std::vector<Clip> make_corpus(size_t num_clips) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> seconds(5.0f, 30.0f);
+    std::uniform_real_distribution<float> noise(-0.1f, 0.1f);
+
+    std::vector<Clip> corpus(num_clips);
+    for (size_t c = 0; c < num_clips; c++) {
+        size_t length = (size_t)(seconds(rng) * 44100.0f);
+        float freq = 110.0f * (1 + c % 8);
+
+        corpus[c].left.resize(length);
+        corpus[c].right.resize(length);
+        for (size_t i = 0; i < length; i++) {
+            float tone = 0.3f * std::sin(2.0f * M_PI * freq * i / 44100.0f);
+            corpus[c].left[i] = tone + noise(rng);
+            corpus[c].right[i] = tone + noise(rng);
+        }
+    }
+    return corpus;
+}
+
+// returns clips per second, outputs gets every clip's left then right overlap-added output
+double run_corpus(const std::vector<Clip>& corpus, ModelHandler& model, ParallelDSP& parallel_dsp, DSPCore& dsp,
+                  const SchedulerConfig& config, bool per_file, SchedulerStats& totals, std::vector<std::vector<float>>& outputs) {
+
+    outputs.assign(corpus.size(), {});
+
+    auto start = std::chrono::steady_clock::now();
+
+    size_t group = per_file ? 1 : corpus.size();
+    for (size_t first = 0; first < corpus.size(); first += group) {
+        BatchScheduler scheduler(model, parallel_dsp, config);
+
+        for (size_t c = first; c < std::min(corpus.size(), first + group); c++) {
+            scheduler.add_file(dsp.pad_audio(corpus[c].left), dsp.pad_audio(corpus[c].right));
+        }
+        scheduler.run();
+
+        for (size_t c = first; c < std::min(corpus.size(), first + group); c++) {
+            std::vector<float> left, right;
+            scheduler.take_output(c - first, left, right);
+            outputs[c] = std::move(left);
+            outputs[c].insert(outputs[c].end(), right.begin(), right.end());
+        }
+
+        const SchedulerStats& stats = scheduler.get_stats();
+        totals.files += stats.files;
+        totals.runs += stats.runs;
+        totals.segments += stats.segments;
+        totals.useful_frames += stats.useful_frames;
+        totals.padded_frames += stats.padded_frames;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return corpus.size() / elapsed;
+}
+
+void print_stats(const std::string& label, double clips_per_second, const SchedulerStats& stats) {
+    size_t total_frames = stats.useful_frames + stats.padded_frames;
+    std::cout << label << ": " << clips_per_second << " clips/s, "
+              << stats.runs << " runs, " << stats.segments << " segments, "
+              << 100.0 * stats.padded_frames / std::max<size_t>(total_frames, 1) << "% padding" << std::endl;
+}
+
+// 10 * log10(|reference|^2 / |reference - estimate|^2)
+double snr_db(const std::vector<float>& reference, const std::vector<float>& estimate) {
+    double signal = 0.0, error = 0.0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        double diff = (double)reference[i] - estimate[i];
+        signal += (double)reference[i] * reference[i];
+        error += diff * diff;
+    }
+    if (error == 0.0) return INFINITY;
+    return 10.0 * std::log10(signal / error);
+}
+
+// lowest and median per-clip SNR of outputs against the per-file outputs
+void print_accuracy(const std::string& label, const std::vector<std::vector<float>>& reference, const std::vector<std::vector<float>>& outputs) {
+    std::vector<double> snrs;
+    for (size_t c = 0; c < reference.size(); c++) snrs.push_back(snr_db(reference[c], outputs[c]));
+    std::sort(snrs.begin(), snrs.end());
+
+    size_t below = std::count_if(snrs.begin(), snrs.end(), [](double snr) { return snr < 60.0; });
+    std::cout << label << ": SNR vs per-file min " << snrs.front() << " dB, median " << snrs[snrs.size() / 2]
+              << " dB, " << below << " of " << snrs.size() << " clips below 60 dB" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    std::string model_path = argc > 1 ? argv[1] : "models/UVR_MDXNET_KARA_2.onnx";
+    size_t num_clips = argc > 2 ? std::max<size_t>(std::stoul(argv[2]), 1) : 32;
+    size_t guard_frames = argc > 3 ? std::stoul(argv[3]) : SchedulerConfig().guard_frames;
+
+    uint32_t n_fft = 4096;
+    uint32_t hop_length = 1024;
+
+    try {
+        ModelHandler model;
+        model.load_model(model_path);
+
+        DSPCore dsp(n_fft, hop_length);
+        ParallelDSP parallel_dsp(n_fft, hop_length);
+
+        std::vector<Clip> corpus = make_corpus(num_clips);
+        std::cout << num_clips << " clips, model batching " << (model.supports_batching() ? "dynamic" : "fixed to 1") << std::endl;
+
+        // the previous pipeline: one file per scheduler, one segment per run
+        SchedulerConfig per_file_config;
+        per_file_config.max_batch = 1;
+        per_file_config.pack_tails = false;
+
+        SchedulerStats per_file_stats;
+        std::vector<std::vector<float>> per_file_outputs, batched_outputs, packed_outputs;
+        double per_file_rate = run_corpus(corpus, model, parallel_dsp, dsp, per_file_config, true, per_file_stats, per_file_outputs);
+        print_stats("per-file", per_file_rate, per_file_stats);
+
+        SchedulerConfig batched_config;
+        SchedulerStats batched_stats;
+        double batched_rate = run_corpus(corpus, model, parallel_dsp, dsp, batched_config, false, batched_stats, batched_outputs);
+        print_stats("batched ", batched_rate, batched_stats);
+
+        SchedulerConfig packed_config;
+        packed_config.pack_tails = true;
+        packed_config.guard_frames = guard_frames;
+        SchedulerStats packed_stats;
+        double packed_rate = run_corpus(corpus, model, parallel_dsp, dsp, packed_config, false, packed_stats, packed_outputs);
+        print_stats("packed  ", packed_rate, packed_stats);
+
+        // batching alone should match exactly; packed tails see neighbouring clips through the guard frames
+        print_accuracy("batched ", per_file_outputs, batched_outputs);
+        print_accuracy("packed  ", per_file_outputs, packed_outputs);
+
+        std::cout << "speedup: batched " << batched_rate / per_file_rate << "x, packed tails " << packed_rate / per_file_rate << "x" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
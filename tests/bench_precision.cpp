@@ -0,0 +1,130 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include "BatchScheduler.h"
+#include "DSPCore.h"
+#include "ModelHandler.h"
+#include "ParallelDSP.h"
+#include "utils.h"
+
+// runs a float model and a reduced-precision (fp16 or int8) variant on the same synthetic
+// input and reports their spectral error, SDR and speed
+// usage: ./precision_bench <float.onnx> <reduced.onnx> [seconds of audio]
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 10 * log10(|reference|^2 / |reference - estimate|^2)
+double signal_to_error_db(const std::vector<float>& reference, const std::vector<float>& estimate) {
+    double signal = 0.0, error = 0.0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        double diff = (double)reference[i] - estimate[i];
+        signal += (double)reference[i] * reference[i];
+        error += diff * diff;
+    }
+    if (error == 0.0) return INFINITY;
+    return 10.0 * std::log10(signal / error);
+}
+
+// best time of a few runs of one segment
+double time_segment(ModelHandler& model, const std::vector<float>& tensor, const std::vector<int64_t>& shape, std::vector<float>& output) {
+    output = model.run_inference(tensor, shape); // warm up
+
+    double best = 1e9;
+    for (int run = 0; run < 5; run++) {
+        auto start = std::chrono::steady_clock::now();
+        output = model.run_inference(tensor, shape);
+        best = std::min(best, seconds_since(start));
+    }
+    return best;
+}
+
+// full analysis -> inference -> synthesis pass, returns seconds
+double run_pipeline(ModelHandler& model, ParallelDSP& parallel_dsp, const std::vector<float>& left_padded, const std::vector<float>& right_padded,
+                    std::vector<float>& left_output, std::vector<float>& right_output) {
+    SchedulerConfig config;
+    config.max_batch = 1;
+    config.pack_tails = false;
+
+    auto start = std::chrono::steady_clock::now();
+
+    BatchScheduler scheduler(model, parallel_dsp, config);
+    scheduler.add_file(left_padded, right_padded);
+    scheduler.run();
+    scheduler.take_output(0, left_output, right_output);
+
+    return seconds_since(start);
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 3) {
+        std::cout << "usage: ./precision_bench <float.onnx> <reduced.onnx> [seconds]" << std::endl;
+        return 1;
+    }
+
+    std::string reference_path = argv[1];
+    std::string reduced_path = argv[2];
+    double seconds = argc > 3 ? std::stod(argv[3]) : 20.0;
+
+    uint32_t n_fft = 4096;
+    uint32_t hop_length = 1024;
+
+    try {
+        ModelHandler reference, reduced;
+        reference.load_model(reference_path);
+        reduced.load_model(reduced_path);
+
+        // chords over noise, different per channel
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+        size_t length = (size_t)(seconds * 44100.0);
+        std::vector<float> left(length), right(length);
+        for (size_t i = 0; i < length; i++) {
+            float t = i / 44100.0f;
+            float chord = std::sin(2.0f * M_PI * 220.0f * t) + 0.5f * std::sin(2.0f * M_PI * 277.2f * t) + 0.3f * std::sin(2.0f * M_PI * 329.6f * t);
+            left[i] = 0.2f * chord + noise(rng);
+            right[i] = 0.2f * chord * (0.5f + 0.5f * std::sin(2.0f * M_PI * 0.25f * t)) + noise(rng);
+        }
+
+        DSPCore dsp(n_fft, hop_length);
+        ParallelDSP parallel_dsp(n_fft, hop_length);
+        std::vector<float> left_padded = dsp.pad_audio(left);
+        std::vector<float> right_padded = dsp.pad_audio(right);
+
+        // one segment straight through the models
+        size_t count = std::min<size_t>(256, parallel_dsp.frame_count(left_padded.size()));
+        std::vector<float> tensor = stft_to_tensor(parallel_dsp.analyze(left_padded, 0, count), parallel_dsp.analyze(right_padded, 0, count));
+        std::vector<int64_t> input_shape = {1, 4, 2048, 256};
+
+        std::vector<float> reference_out, reduced_out;
+        double reference_time = time_segment(reference, tensor, input_shape, reference_out);
+        double reduced_time = time_segment(reduced, tensor, input_shape, reduced_out);
+
+        std::cout << "segment: " << reference.io_precision() << " io " << reference_time * 1000.0 << " ms, "
+                  << reduced.io_precision() << " io " << reduced_time * 1000.0 << " ms, speedup " << reference_time / reduced_time << "x" << std::endl;
+        std::cout << "spectral signal-to-error: " << signal_to_error_db(reference_out, reduced_out) << " dB" << std::endl;
+
+        // whole pipeline
+        std::vector<float> reference_left, reference_right, reduced_left, reduced_right;
+        double reference_pipeline = run_pipeline(reference, parallel_dsp, left_padded, right_padded, reference_left, reference_right);
+        double reduced_pipeline = run_pipeline(reduced, parallel_dsp, left_padded, right_padded, reduced_left, reduced_right);
+
+        double sdr = (signal_to_error_db(reference_left, reduced_left) + signal_to_error_db(reference_right, reduced_right)) / 2.0;
+
+        std::cout << "pipeline (" << seconds << " s of audio): " << reference_pipeline << " s vs " << reduced_pipeline
+                  << " s, speedup " << reference_pipeline / reduced_pipeline << "x" << std::endl;
+        std::cout << "SDR of reduced output against float output: " << sdr << " dB" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
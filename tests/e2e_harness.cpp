@@ -0,0 +1,185 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "test_models.h"
+
+// end-to-end regression and throughput harness: runs the separator binary on the
+// stand-in models and synthetic audio, checks the reconstruction against the
+// known expected signal and records the realtime factor and the measured vs
+// estimated peak memory of every run.
+// usage: ./e2e_harness <path/to/separator> [work_dir] [results.csv]
+
+struct Case {
+    std::string name;
+    std::string options;
+    std::vector<std::string> inputs;     // clip names in the work dir
+    std::vector<std::string> references; // expected output for each input
+    double min_snr_db;                   // -INFINITY: the case only has to run
+    std::string reference_case = "";     // compare against this case's outputs instead of the clips
+};
+
+// the first and last hop of a file never reach full window overlap, so the fixed COLA
+// normalization is off there; compare the interior only
+static const size_t EDGE_VALUES = 2 * 4096;
+
+double snr_db(const std::vector<float>& reference, const std::vector<float>& output) {
+    if (reference.size() != output.size() || reference.size() <= 2 * EDGE_VALUES) return -INFINITY;
+
+    double signal = 0.0, error = 0.0;
+    for (size_t i = EDGE_VALUES; i < reference.size() - EDGE_VALUES; i++) {
+        double diff = (double)reference[i] - output[i];
+        signal += (double)reference[i] * reference[i];
+        error += diff * diff;
+    }
+    if (error == 0.0) return INFINITY;
+    return 10.0 * std::log10(signal / error);
+}
+
+// measured and estimated peak in MB from the "peak memory: ..." line separator prints, 0 if missing
+// (sharded runs report per worker in the shard logs instead)
+std::pair<double, double> read_peak_memory(const std::string& log_path) {
+    std::ifstream log(log_path);
+    std::string line;
+    std::pair<double, double> peak = {0.0, 0.0};
+
+    while (std::getline(log, line)) {
+        double measured, estimated;
+        if (std::sscanf(line.c_str(), "peak memory: %lf MB measured, %lf MB estimated", &measured, &estimated) == 2) {
+            peak = {measured, estimated};
+        }
+    }
+    return peak;
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 2) {
+        std::cout << "usage: ./e2e_harness <path/to/separator> [work_dir] [results.csv]" << std::endl;
+        return 1;
+    }
+
+    std::string separator = std::filesystem::absolute(argv[1]).string();
+    std::string dir = argc > 2 ? argv[2] : "e2e_work";
+    std::string results_path = argc > 3 ? argv[3] : "";
+
+    int failures = 0;
+
+    try {
+        std::filesystem::create_directories(dir);
+        write_test_models(dir);
+
+        // clips: a 20 s clip, the same clip with a 15 kHz tone the mask model removes,
+        // three short clips for batching and a 40 s clip for sharding
+        std::vector<std::pair<std::string, std::vector<float>>> clips(6);
+        clips[0].first = "clip";
+        make_test_audio(20.0, 0.0, clips[0].second);
+        clips[1].first = "clip_high";
+        make_test_audio(20.0, 15000.0, clips[1].second);
+        for (int s = 0; s < 3; s++) {
+            clips[2 + s].first = "short" + std::to_string(s);
+            make_test_audio(5.0 + 3.5 * s, 0.0, clips[2 + s].second);
+        }
+        clips[5].first = "long";
+        make_test_audio(40.0, 0.0, clips[5].second);
+
+        auto audio_of = [&](const std::string& name) -> const std::vector<float>& {
+            for (const auto& clip : clips) {
+                if (clip.first == name) return clip.second;
+            }
+            throw std::runtime_error("unknown clip " + name);
+        };
+
+        for (const auto& clip : clips) {
+            write_test_wav(dir + "/" + clip.first + ".wav", clip.second);
+        }
+
+        std::vector<Case> cases = {
+            {"identity", "--model identity.onnx", {"clip"}, {"clip"}, 40.0},
+            // the mask also drops the noise above 11 kHz, which caps this near 30 dB; without the mask the tone alone gives ~10 dB
+            {"mask", "--model mask.onnx", {"clip_high"}, {"clip"}, 20.0},
+            {"conv", "--model conv.onnx", {"clip"}, {"clip"}, 40.0},
+            {"conv_budget", "--model conv.onnx --max-memory 4G", {"clip"}, {"clip"}, 40.0},
+            {"identity_fp16", "--model identity.onnx --precision fp16", {"clip"}, {"clip"}, 40.0},
+            {"batched", "--model identity_batched.onnx --batch 4", {"short0", "short1", "short2"}, {"short0", "short1", "short2"}, 40.0},
+            // a file's output must not depend on the files batched with it; blur mixes along time,
+            // so anything leaking between batch entries or shifting a segment shows up
+            {"blur", "--model blur_batched.onnx --batch 1", {"short0", "short1", "short2"}, {}, -INFINITY},
+            {"blur_batched", "--model blur_batched.onnx --batch 4", {"short0", "short1", "short2"}, {}, 100.0, "blur"},
+            {"sharded", "--model identity.onnx --shards 2", {"long"}, {"long"}, 40.0},
+            // shard boundaries must sit on the segment grid with enough context for the merge to match
+            // a single process; blur makes any misaligned segment or short context visible
+            {"blur_long", "--model blur_batched.onnx", {"long"}, {}, -INFINITY},
+            {"blur_sharded", "--model blur_batched.onnx --shards 3", {"long"}, {}, 100.0, "blur_long"},
+        };
+
+        std::ofstream results;
+        if (!results_path.empty()) {
+            bool new_file = !std::filesystem::exists(results_path);
+            results.open(results_path, std::ios::app);
+            if (new_file) results << "case,audio_seconds,wall_seconds,realtime_factor,min_snr_db,measured_peak_mb,estimated_peak_mb" << std::endl;
+        }
+
+        std::cout << "case            audio s   wall s   x realtime   min SNR dB   peak MB (estimate)" << std::endl;
+
+        for (const Case& c : cases) {
+            std::string cmd = "cd \"" + dir + "\" && \"" + separator + "\" --no-preprocess " + c.options;
+            double audio_seconds = 0.0;
+
+            for (const std::string& input : c.inputs) {
+                cmd += " " + input + ".wav " + c.name + "_" + input + "_out.wav";
+                audio_seconds += audio_of(input).size() / 2 / 44100.0;
+            }
+            cmd += " > " + c.name + ".log 2>&1";
+
+            auto start = std::chrono::steady_clock::now();
+            int status = std::system(cmd.c_str());
+            double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            double min_snr = INFINITY;
+            if (status != 0) {
+                min_snr = -INFINITY;
+            } else {
+                for (size_t i = 0; i < c.inputs.size() && c.min_snr_db > -INFINITY; i++) {
+                    std::vector<float> output = read_test_wav(dir + "/" + c.name + "_" + c.inputs[i] + "_out.wav");
+                    std::vector<float> reference = c.reference_case.empty() ? audio_of(c.references[i])
+                        : read_test_wav(dir + "/" + c.reference_case + "_" + c.inputs[i] + "_out.wav");
+                    min_snr = std::min(min_snr, snr_db(reference, output));
+                }
+            }
+
+            bool passed = status == 0 && min_snr >= c.min_snr_db;
+            if (!passed) failures++;
+
+            std::pair<double, double> peak = read_peak_memory(dir + "/" + c.name + ".log");
+
+            std::printf("%-15s %7.1f %8.2f %12.2f %12.1f %9.0f (%6.0f)  %s\n", c.name.c_str(), audio_seconds, wall, audio_seconds / wall, min_snr,
+                        peak.first, peak.second, passed ? "ok" : (status != 0 ? "FAILED (see log)" : "FAILED"));
+
+            if (results.is_open()) {
+                results << c.name << "," << audio_seconds << "," << wall << "," << audio_seconds / wall << "," << min_snr << ","
+                        << peak.first << "," << peak.second << std::endl;
+            }
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " case(s) failed, logs are in " << dir << std::endl;
+        return 1;
+    }
+
+    std::cout << "success!" << std::endl;
+    return 0;
+}
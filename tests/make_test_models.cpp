@@ -0,0 +1,37 @@
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include "test_models.h"
+
+// writes the stand-in onnx models and a synthetic test clip, so the benches and
+// separator itself can run without downloading UVR_MDXNET_KARA_2.onnx
+// usage: ./make_test_models [output_dir] [seconds]
+
+int main(int argc, char* argv[]) {
+
+    std::string dir = argc > 1 ? argv[1] : "test_models";
+    double seconds = argc > 2 ? std::stod(argv[2]) : 30.0;
+
+    try {
+        std::filesystem::create_directories(dir);
+
+        std::vector<std::string> files = write_test_models(dir);
+
+        std::vector<float> stereo;
+        make_test_audio(seconds, 0.0, stereo);
+        write_test_wav(dir + "/test_audio.wav", stereo);
+        files.push_back("test_audio.wav");
+
+        std::cout << "wrote";
+        for (size_t f = 0; f < files.size(); f++) {
+            std::cout << (f == 0 ? " " : ", ") << files[f];
+        }
+        std::cout << " to " << dir << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "fp16.h"
+
+// checks the float <-> half conversion used at fp16 model boundaries:
+// every half value round-trips, rounding is to nearest even, and the
+// vectorized paths agree with the scalar ones
+
+int main() {
+
+    int failures = 0;
+
+    // every finite and infinite half survives half -> float -> half, through both paths
+    std::vector<uint16_t> halves(65536);
+    for (uint32_t h = 0; h < 65536; h++) halves[h] = (uint16_t)h;
+
+    std::vector<float> floats(halves.size());
+    half_to_float(halves.data(), floats.data(), halves.size());
+
+    std::vector<uint16_t> back(halves.size());
+    float_to_half(floats.data(), back.data(), floats.size());
+
+    for (uint32_t h = 0; h < 65536; h++) {
+        bool is_nan = (h & 0x7c00) == 0x7c00 && (h & 0x3ff) != 0;
+
+        float scalar = half_to_float((uint16_t)h);
+        if (std::memcmp(&scalar, &floats[h], sizeof(float)) != 0) {
+            if (failures < 5) std::cerr << "half_to_float mismatch for " << h << std::endl;
+            failures++;
+        }
+
+        if (!is_nan && back[h] != h) {
+            if (failures < 5) std::cerr << "round trip failed for " << h << ": " << back[h] << std::endl;
+            failures++;
+        }
+        if (is_nan && (back[h] & 0x7c00) != 0x7c00) {
+            if (failures < 5) std::cerr << "nan lost for " << h << std::endl;
+            failures++;
+        }
+    }
+
+    // rounding: ties go to even, overflow goes to inf, tiny values flush to signed zero
+    struct Case { float value; uint16_t expected; };
+    std::vector<Case> cases = {
+        {1.0f, 0x3c00},
+        {1.0f + 1.0f / 2048.0f, 0x3c00},              // halfway between 1 and the next half, rounds to even
+        {1.0f + 3.0f / 2048.0f, 0x3c02},              // halfway, rounds up to even
+        {65504.0f, 0x7bff},                           // largest half
+        {65520.0f, 0x7c00},                           // rounds to inf
+        {-1e10f, 0xfc00},
+        {5.9604645e-8f, 0x0001},                      // smallest subnormal half
+        {1e-10f, 0x0000},
+        {-1e-10f, 0x8000},
+    };
+
+    std::vector<float> case_values;
+    for (const Case& c : cases) case_values.push_back(c.value);
+    std::vector<uint16_t> case_halves(cases.size());
+    float_to_half(case_values.data(), case_halves.data(), case_values.size());
+
+    for (size_t i = 0; i < cases.size(); i++) {
+        if (float_to_half(cases[i].value) != cases[i].expected || case_halves[i] != cases[i].expected) {
+            std::cerr << "float_to_half(" << cases[i].value << ") = " << float_to_half(cases[i].value)
+                      << " / " << case_halves[i] << ", expected " << cases[i].expected << std::endl;
+            failures++;
+        }
+    }
+
+    // vectorized and scalar float -> half agree on a spread of values, with an odd length for the tail
+    std::vector<float> values(100003);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = std::sin(i * 0.1f) * std::pow(2.0f, (float)(i % 40) - 20.0f);
+    }
+    std::vector<uint16_t> converted(values.size());
+    float_to_half(values.data(), converted.data(), values.size());
+
+    for (size_t i = 0; i < values.size(); i++) {
+        if (converted[i] != float_to_half(values[i])) {
+            if (failures < 5) std::cerr << "vectorized float_to_half mismatch for " << values[i] << std::endl;
+            failures++;
+        }
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " failures" << std::endl;
+        return 1;
+    }
+
+    std::cout << "success!" << std::endl;
+    return 0;
+}
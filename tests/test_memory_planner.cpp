@@ -0,0 +1,82 @@
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include "MemoryPlanner.h"
+
+// checks the memory planner's estimates and the plans it picks under a budget
+
+int main() {
+
+    int failures = 0;
+
+    ModelGeometry geometry;
+    geometry.model_bytes = 50ull << 20;
+
+    size_t three_minutes = 44100 * 180;
+    size_t one_hour = 44100 * 3600;
+
+    // more of anything costs more
+    size_t base = estimate_peak_memory(geometry, three_minutes, 1, 4, 1);
+    if (estimate_peak_memory(geometry, one_hour, 1, 4, 1) <= base) { std::cerr << "length not accounted" << std::endl; failures++; }
+    if (estimate_peak_memory(geometry, three_minutes, 8, 4, 1) <= base) { std::cerr << "window not accounted" << std::endl; failures++; }
+    if (estimate_peak_memory(geometry, three_minutes, 1, 16, 1) <= base) { std::cerr << "threads not accounted" << std::endl; failures++; }
+    if (estimate_peak_memory(geometry, three_minutes, 1, 4, 4) <= base) { std::cerr << "batch not accounted" << std::endl; failures++; }
+
+    // every plan that claims to fit must be under budget, and shrink only as far as needed
+    for (size_t budget_mb : {256ul, 512ul, 1024ul, 2048ul, 8192ul}) {
+        size_t budget = budget_mb << 20;
+
+        for (size_t samples : {44100ul * 10, three_minutes, one_hour}) {
+            MemoryPlan plan = plan_memory(geometry, samples, 64, 4, 8, budget);
+
+            if (plan.fits && plan.estimated_peak > budget) {
+                std::cerr << budget_mb << " MB, " << samples << " samples: plan over budget" << std::endl;
+                failures++;
+            }
+            if (plan.fits && plan.concurrent_sessions * plan.estimated_peak > budget) {
+                std::cerr << budget_mb << " MB, " << samples << " samples: too many sessions" << std::endl;
+                failures++;
+            }
+            if (!plan.fits && (plan.max_batch != 1 || plan.files_per_window != 1)) {
+                std::cerr << budget_mb << " MB, " << samples << " samples: gave up before shrinking fully" << std::endl;
+                failures++;
+            }
+
+            std::cout << budget_mb << " MB, " << samples / 44100 << " s: batch " << plan.max_batch
+                      << ", window " << plan.files_per_window << ", sessions " << plan.concurrent_sessions
+                      << ", estimate " << format_megabytes(plan.estimated_peak) << (plan.fits ? "" : " (does not fit)") << std::endl;
+        }
+    }
+
+    if (parse_memory_size("512M") != 512ull << 20 || parse_memory_size("2G") != 2ull << 30 || parse_memory_size("100") != 100ull << 20) {
+        std::cerr << "memory size parsing" << std::endl;
+        failures++;
+    }
+
+    if (current_memory_usage() == 0 || peak_memory_usage() < current_memory_usage()) {
+        std::cerr << "could not read process memory usage" << std::endl;
+        failures++;
+    }
+
+    // a spike that is already freed when the budget is checked, like one inside a model run, still counts
+    {
+        std::vector<char> spike(256ull << 20, 1);
+        volatile char touched = spike.back();
+        (void)touched;
+    }
+    size_t budget = current_memory_usage() + (64ull << 20);
+    try {
+        enforce_memory_budget(budget, "after spike");
+        if (peak_memory_usage() > budget) {
+            std::cerr << "freed spike over the budget was not reported" << std::endl;
+            failures++;
+        }
+    } catch (const std::runtime_error&) {
+    }
+
+    if (failures > 0) return 1;
+
+    std::cout << "success!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,244 @@
+#include "test_models.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include "WAVHeader.h"
+
+// minimal protobuf encoder, just enough of the onnx schema (onnx.proto) for these graphs
+
+class Proto {
+    public:
+
+    std::string bytes;
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back((char)(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back((char)value);
+    }
+
+    void key(int field, int wire_type) { varint((uint64_t)field << 3 | wire_type); }
+
+    void int_field(int field, int64_t value) { key(field, 0); varint((uint64_t)value); }
+
+    void bytes_field(int field, const std::string& value) { key(field, 2); varint(value.size()); bytes += value; }
+
+    void message_field(int field, const Proto& message) { bytes_field(field, message.bytes); }
+};
+
+// onnx enums
+static const int TENSOR_FLOAT = 1;
+static const int TENSOR_FLOAT16 = 10;
+static const int ATTRIBUTE_INT = 2;
+static const int ATTRIBUTE_INTS = 7;
+
+static Proto attribute_int(const std::string& name, int64_t value) {
+    Proto attribute;
+    attribute.bytes_field(1, name);
+    attribute.int_field(3, value);
+    attribute.int_field(20, ATTRIBUTE_INT);
+    return attribute;
+}
+
+static Proto attribute_ints(const std::string& name, const std::vector<int64_t>& values) {
+    Proto attribute;
+    attribute.bytes_field(1, name);
+    for (int64_t value : values) attribute.int_field(8, value);
+    attribute.int_field(20, ATTRIBUTE_INTS);
+    return attribute;
+}
+
+static Proto node(const std::string& op_type, const std::vector<std::string>& inputs, const std::string& output,
+                  const std::vector<Proto>& attributes = {}) {
+    Proto node;
+    for (const std::string& input : inputs) node.bytes_field(1, input);
+    node.bytes_field(2, output);
+    node.bytes_field(3, output + "_node");
+    node.bytes_field(4, op_type);
+    for (const Proto& attribute : attributes) node.message_field(5, attribute);
+    return node;
+}
+
+static Proto float_tensor(const std::string& name, const std::vector<int64_t>& dims, const std::vector<float>& values) {
+    Proto tensor;
+    for (int64_t dim : dims) tensor.int_field(1, dim);
+    tensor.int_field(2, TENSOR_FLOAT);
+    tensor.bytes_field(8, name);
+    tensor.bytes_field(9, std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float)));
+    return tensor;
+}
+
+// [batch, 4, 2048, 256] tensor value info
+static Proto value_info(const std::string& name, int elem_type, bool dynamic_batch) {
+    Proto shape;
+    std::vector<int64_t> dims = {1, 4, 2048, 256};
+    for (size_t d = 0; d < dims.size(); d++) {
+        Proto dim;
+        if (d == 0 && dynamic_batch) dim.bytes_field(2, "batch");
+        else dim.int_field(1, dims[d]);
+        shape.message_field(1, dim);
+    }
+
+    Proto tensor_type;
+    tensor_type.int_field(1, elem_type);
+    tensor_type.message_field(2, shape);
+
+    Proto type;
+    type.message_field(1, tensor_type);
+
+    Proto info;
+    info.bytes_field(1, name);
+    info.message_field(2, type);
+    return info;
+}
+
+static void write_model(const std::string& path, const std::vector<Proto>& nodes, const std::vector<Proto>& initializers,
+                        int io_type = TENSOR_FLOAT, bool dynamic_batch = false) {
+    Proto graph;
+    for (const Proto& n : nodes) graph.message_field(1, n);
+    graph.bytes_field(2, "mdxnet_stand_in");
+    for (const Proto& initializer : initializers) graph.message_field(5, initializer);
+    graph.message_field(11, value_info("input", io_type, dynamic_batch));
+    graph.message_field(12, value_info("output", io_type, dynamic_batch));
+
+    Proto opset;
+    opset.bytes_field(1, "");
+    opset.int_field(2, 13);
+
+    Proto model;
+    model.int_field(1, 8); // ir_version
+    model.bytes_field(2, "mdxnet_cpp test_models");
+    model.message_field(7, graph);
+    model.message_field(8, opset);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("could not write model: " + path);
+    file.write(model.bytes.data(), model.bytes.size());
+}
+
+void write_identity_model(const std::string& path, bool dynamic_batch, bool fp16_io) {
+    if (fp16_io) {
+        // computed in float like a converted model keeping float internals
+        write_model(path, {
+            node("Cast", {"input"}, "input_float", {attribute_int("to", TENSOR_FLOAT)}),
+            node("Identity", {"input_float"}, "output_float"),
+            node("Cast", {"output_float"}, "output", {attribute_int("to", TENSOR_FLOAT16)}),
+        }, {}, TENSOR_FLOAT16, dynamic_batch);
+        return;
+    }
+
+    write_model(path, {node("Identity", {"input"}, "output")}, {}, TENSOR_FLOAT, dynamic_batch);
+}
+
+void write_mask_model(const std::string& path, int64_t cutoff_bin) {
+    std::vector<float> mask(4 * 2048);
+    for (size_t c = 0; c < 4; c++) {
+        for (int64_t f = 0; f < 2048; f++) {
+            mask[c * 2048 + f] = f < cutoff_bin ? 1.0f : 0.0f;
+        }
+    }
+
+    write_model(path, {node("Mul", {"input", "mask"}, "output")}, {float_tensor("mask", {1, 4, 2048, 1}, mask)});
+}
+
+void write_blur_model(const std::string& path, bool dynamic_batch) {
+    // padding is left out of the average, so edge frames are not pulled towards zero
+    write_model(path, {
+        node("AveragePool", {"input"}, "output", {attribute_ints("kernel_shape", {1, 9}), attribute_ints("pads", {0, 4, 0, 4})}),
+    }, {}, TENSOR_FLOAT, dynamic_batch);
+}
+
+void write_conv_model(const std::string& path, int64_t channels) {
+    std::mt19937 rng(5);
+    std::normal_distribution<float> weight(0.0f, 0.05f);
+
+    auto random_values = [&](size_t count) {
+        std::vector<float> values(count);
+        for (float& value : values) value = weight(rng);
+        return values;
+    };
+
+    size_t c = (size_t)channels;
+    std::vector<Proto> initializers = {
+        float_tensor("w1", {channels, 4, 3, 3}, random_values(c * 4 * 9)),
+        float_tensor("b1", {channels}, random_values(c)),
+        float_tensor("w2", {channels, channels, 3, 3}, random_values(c * c * 9)),
+        float_tensor("b2", {channels}, random_values(c)),
+        float_tensor("w3", {4, channels, 3, 3}, std::vector<float>(4 * c * 9, 0.0f)),
+        float_tensor("b3", {4}, std::vector<float>(4, 0.0f)),
+    };
+
+    std::vector<Proto> conv_attributes = {attribute_ints("kernel_shape", {3, 3}), attribute_ints("pads", {1, 1, 1, 1})};
+
+    write_model(path, {
+        node("Conv", {"input", "w1", "b1"}, "conv1", conv_attributes),
+        node("Relu", {"conv1"}, "relu1"),
+        node("Conv", {"relu1", "w2", "b2"}, "conv2", conv_attributes),
+        node("Relu", {"conv2"}, "relu2"),
+        node("Conv", {"relu2", "w3", "b3"}, "residual", conv_attributes),
+        node("Add", {"input", "residual"}, "output"),
+    }, initializers);
+}
+
+std::vector<std::string> write_test_models(const std::string& dir) {
+    write_identity_model(dir + "/identity.onnx");
+    write_identity_model(dir + "/identity_batched.onnx", true);
+    write_identity_model(dir + "/identity.fp16.onnx", false, true);
+    write_mask_model(dir + "/mask.onnx", 1024);
+    write_blur_model(dir + "/blur_batched.onnx", true);
+    write_conv_model(dir + "/conv.onnx");
+
+    return {"identity.onnx", "identity_batched.onnx", "identity.fp16.onnx", "mask.onnx", "blur_batched.onnx", "conv.onnx"};
+}
+
+void make_test_audio(double seconds, double high_tone_hz, std::vector<float>& stereo) {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+
+    size_t length = (size_t)(seconds * 44100.0);
+    stereo.resize(length * 2);
+
+    for (size_t i = 0; i < length; i++) {
+        float t = i / 44100.0f;
+        float envelope = 0.75f + 0.25f * std::sin(2.0f * M_PI * 0.5f * t);
+        float tones = 0.2f * std::sin(2.0f * M_PI * 220.0f * t) + 0.1f * std::sin(2.0f * M_PI * 440.0f * t) + 0.05f * std::sin(2.0f * M_PI * 880.0f * t);
+        float high = high_tone_hz > 0.0 ? 0.05f * std::sin(2.0f * M_PI * (float)high_tone_hz * t) : 0.0f;
+
+        // noise is drawn even without the high tone so both versions share it
+        float left_noise = noise(rng);
+        float right_noise = noise(rng);
+
+        stereo[i * 2] = envelope * tones + high + left_noise;
+        stereo[i * 2 + 1] = (1.0f - 0.5f * envelope) * tones + high + right_noise;
+    }
+}
+
+void write_test_wav(const std::string& path, const std::vector<float>& stereo) {
+    WAVHeader header;
+    std::memcpy(header.chunk_id, "RIFF", 4);
+    std::memcpy(header.format, "WAVE", 4);
+    std::memcpy(header.subchunk1_id, "fmt ", 4);
+    std::memcpy(header.subchunk2_id, "data", 4);
+    header.subchunk1_size = 16;
+    header.audio_format = 3;
+    header.num_channels = 2;
+    header.sample_rate = 44100;
+    header.bits_per_sample = 32;
+    header.block_align = header.num_channels * (header.bits_per_sample / 8);
+    header.byte_rate = header.sample_rate * header.block_align;
+    header.subchunk2_size = stereo.size() * sizeof(float);
+    header.chunk_size = 36 + header.subchunk2_size;
+
+    std::vector<float> buffer = stereo;
+    write_wav(header, path, buffer);
+}
+
+std::vector<float> read_test_wav(const std::string& path) {
+    std::vector<float> stereo;
+    read_wav(path, stereo);
+    return stereo;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// stand-in models and audio for offline tests. the models follow the MDX-Net
+// [1, 4, 2048, 256] input/output contract, so they drop in for UVR_MDXNET_KARA_2.onnx.
+
+// output = input
+void write_identity_model(const std::string& path, bool dynamic_batch = false, bool fp16_io = false);
+
+// output = input * mask, mask keeps frequency bins below cutoff_bin and zeroes the rest
+void write_mask_model(const std::string& path, int64_t cutoff_bin);
+
+// output = average of each bin over 9 neighbouring frames, so every output frame depends on
+// its neighbours in time and batching or packing mistakes show up as crosstalk
+void write_blur_model(const std::string& path, bool dynamic_batch = false);
+
+// three 3x3 convolutions (4 -> channels -> channels -> 4) with relus, added back onto the input.
+// the last layer's weights are zero so the output equals the input, at roughly MDX-Net-like cost
+void write_conv_model(const std::string& path, int64_t channels = 32);
+
+// writes all of the above into dir and returns the file names written
+std::vector<std::string> write_test_models(const std::string& dir);
+
+// deterministic stereo test signal: three tones with slow amplitude movement over a little noise,
+// plus an optional tone at high_tone_hz (0 = none) that the mask model removes
+void make_test_audio(double seconds, double high_tone_hz, std::vector<float>& stereo);
+
+// 44.1 kHz stereo float wav
+void write_test_wav(const std::string& path, const std::vector<float>& stereo);
+std::vector<float> read_test_wav(const std::string& path);
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include "DSPCore.h"
+#include "ParallelDSP.h"
+
+// reference analysis: the serial loop run_seperation used before ParallelDSP
+std::vector<std::vector<kiss_fft_cpx>> serial_analyze(DSPCore& dsp, const std::vector<float>& padded, uint32_t n_fft, uint32_t hop_length) {
+    std::vector<std::vector<kiss_fft_cpx>> frames;
+
+    for (size_t offset = 0; offset + n_fft <= padded.size(); offset += hop_length) {
+        std::vector<float> frame(n_fft);
+        for (uint32_t i = 0; i < n_fft; i++) {
+            frame[i] = padded[offset + i];
+        }
+        frames.push_back(dsp.stft(frame));
+    }
+
+    return frames;
+}
+
+// reference synthesis: the serial overlap-add loop
+std::vector<float> serial_synthesize(DSPCore& dsp, const std::vector<std::vector<kiss_fft_cpx>>& frames, size_t length, uint32_t n_fft, uint32_t hop_length) {
+    std::vector<float> output(length, 0.0f);
+
+    for (size_t frame_idx = 0; frame_idx < frames.size(); frame_idx++) {
+        std::vector<float> time = dsp.istft(frames[frame_idx]);
+        size_t offset = frame_idx * hop_length;
+
+        for (uint32_t n = 0; n < n_fft; n++) {
+            output[offset + n] += time[n];
+        }
+    }
+
+    return output;
+}
+
+bool same_frames(const std::vector<std::vector<kiss_fft_cpx>>& a, const std::vector<std::vector<kiss_fft_cpx>>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t k = 0; k < a.size(); k++) {
+        if (std::memcmp(a[k].data(), b[k].data(), a[k].size() * sizeof(kiss_fft_cpx)) != 0) return false;
+    }
+    return true;
+}
+
+bool same_samples(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+
+    uint32_t n_fft = 4096;
+    uint32_t hop_length = 1024;
+
+    // 20 seconds of noise plus a tone
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::vector<float> audio(44100 * 20);
+    for (size_t i = 0; i < audio.size(); i++) {
+        audio[i] = noise(rng) + 0.3f * std::sin(2.0f * M_PI * 440.0f * i / 44100.0f);
+    }
+
+    DSPCore dsp(n_fft, hop_length);
+    std::vector<float> padded = dsp.pad_audio(audio);
+
+    std::vector<std::vector<kiss_fft_cpx>> reference_frames = serial_analyze(dsp, padded, n_fft, hop_length);
+    std::vector<float> reference_output = serial_synthesize(dsp, reference_frames, padded.size(), n_fft, hop_length);
+
+    int failures = 0;
+
+    // exact match against the serial path, including thread counts that leave uneven or tiny tiles
+    for (unsigned int threads : {1u, 2u, 3u, 4u, 7u, 16u, 1000u}) {
+        ParallelDSP parallel_dsp(n_fft, hop_length, threads);
+
+        std::vector<std::vector<kiss_fft_cpx>> frames = parallel_dsp.analyze(padded);
+        bool analysis_ok = same_frames(frames, reference_frames);
+
+        std::vector<float> output(padded.size(), 0.0f);
+        parallel_dsp.synthesize(frames, 0, output);
+        bool synthesis_ok = same_samples(output, reference_output);
+
+        // synthesis in uneven chunks must still accumulate in serial order
+        std::vector<float> chunked(padded.size(), 0.0f);
+        for (size_t first = 0; first < frames.size(); first += 97) {
+            size_t count = std::min<size_t>(97, frames.size() - first);
+            std::vector<std::vector<kiss_fft_cpx>> chunk(frames.begin() + first, frames.begin() + first + count);
+            parallel_dsp.synthesize(chunk, first, chunked);
+        }
+        bool chunked_ok = same_samples(chunked, reference_output);
+
+        std::cout << threads << " threads: analysis " << (analysis_ok ? "ok" : "MISMATCH")
+                  << ", synthesis " << (synthesis_ok ? "ok" : "MISMATCH")
+                  << ", chunked synthesis " << (chunked_ok ? "ok" : "MISMATCH") << std::endl;
+
+        if (!analysis_ok || !synthesis_ok || !chunked_ok) failures++;
+    }
+
+    // scaling benchmark
+    std::cout << std::endl << "scaling (" << reference_frames.size() << " frames, best of 3):" << std::endl;
+
+    double serial_time = 0.0;
+    for (unsigned int threads : {1u, 2u, 4u, 8u}) {
+        ParallelDSP parallel_dsp(n_fft, hop_length, threads);
+        double best_analysis = 1e9, best_synthesis = 1e9;
+
+        for (int run = 0; run < 3; run++) {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::vector<kiss_fft_cpx>> frames = parallel_dsp.analyze(padded);
+            best_analysis = std::min(best_analysis, seconds_since(start));
+
+            std::vector<float> output(padded.size(), 0.0f);
+            start = std::chrono::steady_clock::now();
+            parallel_dsp.synthesize(frames, 0, output);
+            best_synthesis = std::min(best_synthesis, seconds_since(start));
+        }
+
+        double total = best_analysis + best_synthesis;
+        if (threads == 1) serial_time = total;
+
+        std::cout << "  " << threads << " threads: analysis " << best_analysis * 1000.0 << " ms, synthesis "
+                  << best_synthesis * 1000.0 << " ms, speedup " << serial_time / total << "x" << std::endl;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " configurations did not match the serial path" << std::endl;
+        return 1;
+    }
+
+    std::cout << "success!" << std::endl;
+    return 0;
+}
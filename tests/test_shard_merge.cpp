@@ -0,0 +1,132 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "ShardPlanner.h"
+
+// checks the shard planner and crossfade merge, and optionally compares a sharded run
+// against a single-process run of the real binary.
+// usage: ./shard_merge_test [<path/to/separator> <input.wav> [num_shards]]
+
+bool check_plan(size_t num_samples, size_t num_shards) {
+    ShardConfig config;
+    std::vector<Shard> shards = plan_shards(num_samples, num_shards, config);
+
+    for (size_t s = 0; s < shards.size(); s++) {
+        const Shard& shard = shards[s];
+
+        if (shard.read_start % config.segment_samples != 0) return false;
+        if (shard.read_end > num_samples || shard.read_start >= shard.read_end) return false;
+        if (shard.fade_in_start < shard.read_start || shard.fade_out_end > shard.read_end) return false;
+
+        // neighbours must crossfade over the same samples
+        if (s + 1 < shards.size()) {
+            const Shard& next = shards[s + 1];
+            if (shard.fade_out_start != next.fade_in_start || shard.fade_out_end != next.fade_in_end) return false;
+        }
+    }
+
+    return shards.front().read_start == 0 && shards.back().read_end == num_samples;
+}
+
+// every shard returns its slice of the input unchanged, so the merge must give the input back
+double merge_error(size_t num_samples, size_t num_shards) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+
+    std::vector<float> signal(num_samples * 2);
+    for (float& sample : signal) sample = noise(rng);
+
+    std::vector<Shard> shards = plan_shards(num_samples, num_shards);
+    std::vector<std::vector<float>> outputs;
+    for (const Shard& shard : shards) {
+        outputs.emplace_back(signal.begin() + shard.read_start * 2, signal.begin() + shard.read_end * 2);
+    }
+
+    std::vector<float> merged = merge_shards(shards, outputs, num_samples);
+
+    double max_error = 0.0;
+    for (size_t i = 0; i < signal.size(); i++) {
+        max_error = std::max(max_error, (double)std::fabs(merged[i] - signal[i]));
+    }
+    return max_error;
+}
+
+std::vector<float> read_samples(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(0, std::ios::end);
+    size_t size = file.tellg();
+    std::vector<float> samples((size - 44) / sizeof(float));
+    file.seekg(44);
+    file.read(reinterpret_cast<char*>(samples.data()), samples.size() * sizeof(float));
+    return samples;
+}
+
+double run_timed(const std::string& cmd) {
+    auto start = std::chrono::steady_clock::now();
+    if (std::system(cmd.c_str()) != 0) throw std::runtime_error("command failed: " + cmd);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+
+    int failures = 0;
+
+    // lengths around the segment grid, from shorter than one segment to a few minutes
+    for (size_t num_samples : {1000ul, 262144ul, 262145ul, 44100ul * 60, 44100ul * 200 + 17}) {
+        for (size_t num_shards : {1ul, 2ul, 3ul, 8ul, 100ul}) {
+            bool plan_ok = check_plan(num_samples, num_shards);
+            double error = merge_error(num_samples, num_shards);
+
+            if (!plan_ok || error > 1e-6) {
+                std::cerr << num_samples << " samples, " << num_shards << " shards: "
+                          << (plan_ok ? "" : "bad plan, ") << "merge error " << error << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    std::cout << "planner/merge checks: " << (failures == 0 ? "ok" : "FAILED") << std::endl;
+
+    if (argc >= 3) {
+        std::string separator = argv[1];
+        std::string input = argv[2];
+        std::string shards = argc > 3 ? argv[3] : "4";
+
+        try {
+            double single_time = run_timed("\"" + separator + "\" \"" + input + "\" shard_test_single.wav > /dev/null");
+            double sharded_time = run_timed("\"" + separator + "\" --shards " + shards + " \"" + input + "\" shard_test_sharded.wav");
+
+            std::vector<float> single = read_samples("shard_test_single.wav");
+            std::vector<float> sharded = read_samples("shard_test_sharded.wav");
+
+            double max_error = single.size() == sharded.size() ? 0.0 : INFINITY;
+            for (size_t i = 0; i < std::min(single.size(), sharded.size()); i++) {
+                max_error = std::max(max_error, (double)std::fabs(single[i] - sharded[i]));
+            }
+
+            std::cout << "single process " << single_time << " s, " << shards << " shards " << sharded_time
+                      << " s, speedup " << single_time / sharded_time << "x, max abs difference " << max_error << std::endl;
+
+            std::remove("shard_test_single.wav");
+            std::remove("shard_test_sharded.wav");
+
+            if (max_error > 1e-4) failures++;
+
+        } catch (const std::exception& e) {
+            std::cerr << "error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (failures > 0) return 1;
+
+    std::cout << "success!" << std::endl;
+    return 0;
+}